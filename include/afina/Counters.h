@@ -0,0 +1,60 @@
+#ifndef AFINA_COUNTERS_H
+#define AFINA_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+
+/**
+ * # Statistics counter updated by a single thread
+ * Only the owner thread writes to the counter, so increment is plain load and store instead of
+ * locked read-modify-write. Value is atomic just to let stats read it from another thread.
+ */
+class Counter {
+public:
+    Counter() : _value(0) {}
+
+    void Add(uint64_t n = 1) { _value.store(_value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+
+    uint64_t Load() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> _value;
+};
+
+/**
+ * # Server statistics of a single thread
+ * Names follow memcached stats. Connections are closed on other thread than accepted sometimes,
+ * so instead of current number two growing counters are kept and subtracted in stats
+ */
+struct Counters {
+    Counter cmd_get;
+    Counter get_hits;
+    Counter get_misses;
+    Counter cmd_set;
+    Counter bytes_read;
+    Counter bytes_written;
+    Counter total_connections;
+    Counter closed_connections;
+    Counter evictions;
+};
+
+/**
+ * Counters of all threads in the process
+ */
+inline Concurrency::ThreadLocal<Counters> &AllCounters() {
+    static Concurrency::ThreadLocal<Counters> counters;
+    return counters;
+}
+
+/**
+ * Counters of the calling thread. Coroutine must not keep the reference over a switch
+ */
+inline Counters &LocalCounters() { return AllCounters().Get(); }
+
+} // namespace Afina
+
+#endif // AFINA_COUNTERS_H
@@ -1,10 +1,73 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <ctime>
+#include <memory>
 #include <string>
 
 namespace Afina {
 
+/**
+ * # Read only view of the value kept in a storage
+ * While view is alive, bytes it points to stay valid and unchanged even if the association gets
+ * updated, deleted or evicted meanwhile. Once view is destroyed or reset storage is free to reuse
+ * memory.
+ *
+ * All views must be released before storage they belong to gets destroyed
+ */
+class ValueView {
+public:
+    // Called once view is done with the value
+    using release_func = void (*)(void *owner, void *item);
+
+    ValueView() : _data(nullptr), _size(0), _release(nullptr), _owner(nullptr), _item(nullptr) {}
+    ValueView(const char *data, size_t size, release_func release, void *owner, void *item)
+        : _data(data), _size(size), _release(release), _owner(owner), _item(item) {}
+    ~ValueView() { Reset(); }
+
+    ValueView(ValueView &&other) : ValueView() { *this = std::move(other); }
+    ValueView &operator=(ValueView &&other) {
+        if (this != &other) {
+            Reset();
+            _data = other._data;
+            _size = other._size;
+            _release = other._release;
+            _owner = other._owner;
+            _item = other._item;
+            other._release = nullptr;
+            other.Reset();
+        }
+        return *this;
+    }
+
+    inline const char *data() const { return _data; }
+    inline size_t size() const { return _size; }
+
+    /**
+     * Unpin the value, view becomes empty
+     */
+    void Reset() {
+        if (_release != nullptr) {
+            _release(_owner, _item);
+        }
+        _data = nullptr;
+        _size = 0;
+        _release = nullptr;
+        _owner = _item = nullptr;
+    }
+
+private:
+    ValueView(const ValueView &) = delete;
+    ValueView &operator=(const ValueView &) = delete;
+
+    const char *_data;
+    size_t _size;
+
+    release_func _release;
+    void *_owner;
+    void *_item;
+};
+
 /**
  *
  */
@@ -27,8 +90,10 @@ public:
      *
      * @param key to be associated with value
      * @param value to be assigned for the key
+     * @param expire_at absolute time in seconds since epoch when association expires, 0 means it
+     * never does. Association with expiration time in the past is not visible right away
      */
-    virtual bool Put(const std::string &key, const std::string &value) = 0;
+    virtual bool Put(const std::string &key, const std::string &value, std::time_t expire_at = 0) = 0;
 
     /**
      * Stores association between given key/value pair if key isn't present in
@@ -40,8 +105,10 @@ public:
      *
      * @param key to be associated with value
      * @param value to be assigned for the key
+     * @param expire_at absolute time in seconds since epoch when association expires, 0 means it
+     * never does. Association with expiration time in the past is not visible right away
      */
-    virtual bool PutIfAbsent(const std::string &key, const std::string &value) = 0;
+    virtual bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at = 0) = 0;
 
     /**
      * Updates existing association between given key/value pair
@@ -53,8 +120,10 @@ public:
      *
      * @param key to be associated with value
      * @param value to be assigned for the key
+     * @param expire_at absolute time in seconds since epoch when association expires, 0 means it
+     * never does. Association with expiration time in the past is not visible right away
      */
-    virtual bool Set(const std::string &key, const std::string &value) = 0;
+    virtual bool Set(const std::string &key, const std::string &value, std::time_t expire_at = 0) = 0;
 
     /**
      * Removes association for the given key
@@ -72,10 +141,18 @@ public:
      */
     virtual bool Delete(const std::string &key) = 0;
 
+    /**
+     * Removes all associations at once
+     *
+     * Values pinned by views stay valid until views are released
+     */
+    virtual void FlushAll() = 0;
+
     /**
      * Retrive key for the given value
      * If there is an association for the given key then method copies value
-     * into given output parameter (possibly extends its size) and return true
+     * into given output parameter (possibly extends its size) and return true.
+     * Expired associations are never returned
      *
      * In case if given key not found method returns false and doesn't perform
      * any changes on the output parameter
@@ -84,6 +161,47 @@ public:
      * @param value output parameter to copy value to
      */
     virtual bool Get(const std::string &key, std::string &value) = 0;
+
+    /**
+     * Retrive value for the given key along with its expiration time
+     * Same as Get, in addition expire_at is set to the absolute time in seconds since epoch when
+     * association expires, 0 if it never does. Commands that modify existing value use it to keep
+     * expiration time unchanged
+     *
+     * @param key to retrive value for
+     * @param value output parameter to copy value to
+     * @param expire_at output parameter to copy expiration time to
+     */
+    virtual bool Get(const std::string &key, std::string &value, std::time_t &expire_at) = 0;
+
+    /**
+     * Retrive value for the given key without copying it
+     * If there is an association for the given key then method makes given view to point to the
+     * value and return true. Storage keeps value memory pinned until view is released.
+     *
+     * Any value view pointed to before is released first, even if given key is not found. In that
+     * case method returns false and view stays empty
+     *
+     * Default implementation copies value by Get, so it is only worth to call for storages that
+     * override it
+     *
+     * @param key to retrive value for
+     * @param value output parameter to point to the value
+     */
+    virtual bool Pin(const std::string &key, ValueView &value) {
+        value.Reset();
+        std::unique_ptr<std::string> copy(new std::string());
+        if (!Get(key, *copy)) {
+            return false;
+        }
+
+        value = ValueView(copy->data(), copy->size(), &ReleaseCopy, nullptr, copy.get());
+        copy.release();
+        return true;
+    }
+
+private:
+    static void ReleaseCopy(void *, void *item) { delete static_cast<std::string *>(item); }
 };
 
 } // namespace Afina
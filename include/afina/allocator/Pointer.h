@@ -7,6 +7,14 @@ namespace Allocator {
 // to avoid expensive macros calculations and increase compile speed
 class Simple;
 
+/**
+ * Handle of the memory allocated by Simple. Allocator could move memory around, so pointer refers
+ * to the descriptor which keeps actual address, rather than to the memory itself. Value returned
+ * by get() is only valid until the next call to the allocator that could move blocks.
+ *
+ * Copies of the pointer refer to the same memory, once it is freed by any of them others are
+ * dangling just like raw pointers
+ */
 class Pointer {
 public:
     Pointer();
@@ -17,7 +25,15 @@ public:
     Pointer &operator=(const Pointer &);
     Pointer &operator=(Pointer &&);
 
-    void *get() const { return 0; }
+    void *get() const { return _descriptor != nullptr ? *_descriptor : nullptr; }
+
+private:
+    friend class Simple;
+
+    explicit Pointer(void **descriptor) : _descriptor(descriptor) {}
+
+    // Slot of the descriptor table owned by allocator
+    void **_descriptor;
 };
 
 } // namespace Allocator
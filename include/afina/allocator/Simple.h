@@ -18,6 +18,14 @@ class Pointer;
  * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
  * on destruction. So caller must take care of resource cleaup after allocator stop
  * being needs
+ *
+ * Blocks are placed one after another from the beginning of the area, each one has a small header
+ * with its size and descriptor. Descriptors table grows down from the end of the area, Pointer
+ * refers to the descriptor, so blocks could be moved by defrag without invalidating pointers.
+ * Freed blocks are kept in the free list and reused first fit, block at the top is given back
+ * to the unused space between blocks and descriptors.
+ *
+ * That is NOT thread safe implementaiton!!
  */
 // TODO: Implements interface to allow usage as C++ allocators
 class Simple {
@@ -25,37 +33,108 @@ public:
     Simple(void *base, const size_t size);
 
     /**
-     * TODO: semantics
+     * Allocates block of at least N bytes
+     *
+     * Throws AllocError of NoMemory type if there is no free block big enough, even if defrag
+     * could make one
+     *
      * @param N size_t
      */
     Pointer alloc(size_t N);
 
     /**
-     * TODO: semantics
+     * Changes size of the block keeping its content up to the smaller of old and new sizes. Block
+     * is resized in place whenever possible, otherwise it is moved. Empty pointer gets a new block.
+     *
+     * Throws AllocError of NoMemory type if block can't be resized, original block stays intact
+     *
      * @param p Pointer
      * @param N size_t
      */
     void realloc(Pointer &p, size_t N);
 
     /**
-     * TODO: semantics
+     * Releases block and resets pointer, empty pointer is ignored
+     *
      * @param p Pointer
      */
     void free(Pointer &p);
 
     /**
-     * TODO: semantics
+     * Moves all blocks to the beginning of the area one after another, so that all unused memory
+     * forms a single region. Pointers stay valid, raw addresses obtained from them do not
      */
     void defrag();
 
     /**
-     * TODO: semantics
+     * Returns number of bytes not taken by used blocks with their headers and by descriptors
+     * table. Some of them could be scattered over free blocks, defrag puts them together
+     */
+    size_t available() const;
+
+    /**
+     * Returns number of bytes taken by used blocks with their headers, they become available once
+     * blocks are freed
+     */
+    size_t used() const { return _used; }
+
+    /**
+     * Returns number of bytes block of N bytes takes from available ones, including its header and
+     * descriptor. Once available() is at least that much alloc(N) succeeds, possibly after defrag
+     *
+     * @param N size_t
+     */
+    static size_t footprint(size_t N);
+
+    /**
+     * Returns human readable map of the area, one block per line
      */
     std::string dump() const;
 
 private:
+    Simple(const Simple &) = delete;
+    Simple &operator=(const Simple &) = delete;
+
+    struct block;
+
+    // Returns free block of at least size bytes, throws AllocError if there is none
+    block *TakeBlock(size_t size);
+
+    // Puts block to the free list or back to the unused space
+    void ReleaseBlock(block *b);
+
+    // Cuts tail of the block that isn't needed to hold size bytes into a separate free block
+    void Split(block *b, size_t size);
+
+    void LinkFree(block *b);
+    void UnlinkFree(block *b);
+
+    void **TakeDescriptor();
+    void ReleaseDescriptor(void **descriptor);
+
+    // Bytes between the last block and the descriptors table
+    inline size_t Unused() const { return reinterpret_cast<char *>(_descriptors) - _top; }
+
     void *_base;
     const size_t _base_len;
+
+    // First block
+    char *_begin;
+
+    // End of the last block
+    char *_top;
+
+    // The lowest slot of the descriptors table
+    void **_descriptors;
+
+    // Descriptors which could be reused, each one keeps next free descriptor
+    void **_free_descriptors;
+
+    // Doubly linked list of free blocks
+    block *_free_blocks;
+
+    // Bytes taken by used blocks including headers
+    size_t _used;
 };
 
 } // namespace Allocator
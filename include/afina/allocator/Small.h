@@ -0,0 +1,82 @@
+#ifndef AFINA_ALLOCATOR_SMALL_H
+#define AFINA_ALLOCATOR_SMALL_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Allocator of small objects with per thread caches
+ * Built the same way as tarantool small allocator: Arena shared by all threads hands out aligned
+ * slabs, each thread has own SlabCache of free slabs and set of Mempools, one per size class.
+ * So usual allocation and free take no locks and touch no shared cache lines at all.
+ *
+ * Object freed by the thread other than allocated it goes back to its slab through lock-free
+ * stack and is picked up by the owner later. Caches of finished threads are kept and given to
+ * new threads with all the objects still allocated from them.
+ *
+ * Requests bigger than kMaxSize are passed to the system allocator.
+ *
+ * Thread safe implementation
+ */
+class Small {
+public:
+    // The biggest size served by pools
+    static const size_t kMaxSize = 8192;
+
+    /**
+     * Allocates at least size bytes aligned on 16 bytes, throws std::bad_alloc if system runs
+     * out of memory
+     */
+    static void *Alloc(size_t size);
+
+    /**
+     * Releases memory, size must be the same as passed to Alloc. Could be called by any thread
+     */
+    static void Free(void *ptr, size_t size);
+};
+
+/**
+ * Standard C++ allocator on top of Small, so containers and strings could use it
+ */
+template <typename T> class SmallAllocator {
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U> struct rebind { typedef SmallAllocator<U> other; };
+
+    SmallAllocator() {}
+    template <typename U> SmallAllocator(const SmallAllocator<U> &) {}
+
+    T *allocate(std::size_t n) { return static_cast<T *>(Small::Alloc(n * sizeof(T))); }
+    void deallocate(T *p, std::size_t n) { Small::Free(p, n * sizeof(T)); }
+
+    template <typename U, typename... Args> void construct(U *p, Args &&... args) {
+        ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+    }
+    template <typename U> void destroy(U *p) { p->~U(); }
+
+    std::size_t max_size() const { return std::size_t(-1) / sizeof(T); }
+};
+
+template <typename T, typename U> inline bool operator==(const SmallAllocator<T> &, const SmallAllocator<U> &) {
+    return true;
+}
+
+template <typename T, typename U> inline bool operator!=(const SmallAllocator<T> &, const SmallAllocator<U> &) {
+    return false;
+}
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_SMALL_H
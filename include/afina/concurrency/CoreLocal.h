@@ -1,10 +1,98 @@
 #ifndef AFINA_CONCURRENCY_CORE_LOCAL_H
 #define AFINA_CONCURRENCY_CORE_LOCAL_H
 
+#include <cstddef>
+#include <new>
+
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class CoreLocal {};
+/**
+ * # Value per CPU
+ * Keeps separate instance of T for every CPU in the system, each on its own cache lines, so that
+ * threads running on different cores never write to the same line.
+ *
+ * CPU is looked up by sched_getcpu, which glibc answers from rseq area or vDSO without a syscall.
+ * Thread could be moved to another core right after the lookup, so the value still must be safe
+ * to access concurrently, CoreLocal only makes contention unlikely. Whoever needs to release
+ * something on the same slot later has to remember index rather than call Get again.
+ */
+template <typename T> class CoreLocal {
+public:
+    CoreLocal() : _size(CpuCount()), _slots(nullptr) {
+        void *mem = nullptr;
+        if (posix_memalign(&mem, kCacheLine, _size * sizeof(slot)) != 0) {
+            throw std::bad_alloc();
+        }
+
+        _slots = static_cast<slot *>(mem);
+        size_t i = 0;
+        try {
+            for (; i < _size; i++) {
+                new (&_slots[i]) slot();
+            }
+        } catch (...) {
+            Destroy(i);
+            throw;
+        }
+    }
+
+    ~CoreLocal() { Destroy(_size); }
+
+    /**
+     * Number of slots
+     */
+    size_t Size() const { return _size; }
+
+    /**
+     * Index of the slot belonging to CPU calling thread runs on right now
+     */
+    size_t Index() const {
+        int cpu = sched_getcpu();
+        return cpu < 0 ? 0 : size_t(cpu) % _size;
+    }
+
+    /**
+     * Value of the current CPU
+     */
+    T &Get() { return _slots[Index()].value; }
+
+    /**
+     * Value of the given slot
+     */
+    T &At(size_t index) { return _slots[index].value; }
+    const T &At(size_t index) const { return _slots[index].value; }
+
+private:
+    CoreLocal(const CoreLocal &) = delete;
+    CoreLocal &operator=(const CoreLocal &) = delete;
+
+    static const size_t kCacheLine = 64;
+
+    // Padded up to the cache line, adjacent prefetcher is not taken into account
+    struct alignas(kCacheLine) slot {
+        T value;
+    };
+
+    static size_t CpuCount() {
+        long count = sysconf(_SC_NPROCESSORS_CONF);
+        return count > 0 ? size_t(count) : 1;
+    }
+
+    void Destroy(size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            _slots[i].~slot();
+        }
+        free(_slots);
+    }
+
+    const size_t _size;
+    slot *_slots;
+};
 
 } // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,81 @@
+#ifndef AFINA_CONCURRENCY_CORE_RW_LOCK_H
+#define AFINA_CONCURRENCY_CORE_RW_LOCK_H
+
+#include <cstddef>
+#include <stdexcept>
+
+#include <pthread.h>
+
+#include "CoreLocal.h"
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Reader-writer lock distributed over CPUs
+ * Every CPU has own rwlock. Reader takes the one of its CPU only, so readers on different cores
+ * never touch the same cache line, unlike single rwlock where every reader bumps shared counter.
+ * Writer takes all of them in the same order, so writes cost as many lock operations as there are
+ * CPUs: the lock pays off for read mostly data only.
+ *
+ * Thread safe implementation
+ */
+class CoreRWLock {
+public:
+    CoreRWLock() {}
+
+    /**
+     * Takes shared lock, returns slot to be passed to ReadUnlock since thread could move to other
+     * CPU meanwhile
+     */
+    size_t ReadLock() {
+        size_t slot = _locks.Index();
+        pthread_rwlock_rdlock(&_locks.At(slot).value);
+        return slot;
+    }
+
+    void ReadUnlock(size_t slot) { pthread_rwlock_unlock(&_locks.At(slot).value); }
+
+    /**
+     * Takes exclusive lock
+     */
+    void WriteLock() {
+        for (size_t i = 0; i < _locks.Size(); i++) {
+            pthread_rwlock_wrlock(&_locks.At(i).value);
+        }
+    }
+
+    void WriteUnlock() {
+        for (size_t i = _locks.Size(); i > 0; i--) {
+            pthread_rwlock_unlock(&_locks.At(i - 1).value);
+        }
+    }
+
+private:
+    CoreRWLock(const CoreRWLock &) = delete;
+    CoreRWLock &operator=(const CoreRWLock &) = delete;
+
+    struct lock {
+        lock() {
+            // Writer preference, as with the plain lock in ClockLRU, see the reason there
+            pthread_rwlockattr_t attr;
+            pthread_rwlockattr_init(&attr);
+            pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+            int result = pthread_rwlock_init(&value, &attr);
+            pthread_rwlockattr_destroy(&attr);
+            if (result != 0) {
+                throw std::runtime_error("Failed to init rwlock");
+            }
+        }
+        ~lock() { pthread_rwlock_destroy(&value); }
+
+        pthread_rwlock_t value;
+    };
+
+    CoreLocal<lock> _locks;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_CORE_RW_LOCK_H
@@ -1,11 +1,13 @@
 #ifndef AFINA_CONCURRENCY_EXECUTOR_H
 #define AFINA_CONCURRENCY_EXECUTOR_H
 
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
 
@@ -14,6 +16,11 @@ namespace Concurrency {
 
 /**
  * # Thread pool
+ * Keeps at least low_watermark threads alive. Once there are more tasks in the queue than free
+ * threads, new thread is started unless there are high_watermark of them already. Thread which
+ * was idle for idle_time finishes, as long as there are more than low_watermark threads.
+ *
+ * Queue holds at most max_queue_size tasks, the ones above are rejected.
  */
 class Executor {
     enum class State {
@@ -28,7 +35,9 @@ class Executor {
         kStopped
     };
 
-    Executor(std::string name, int size);
+public:
+    Executor(std::string name, size_t low_watermark, size_t high_watermark, size_t max_queue_size,
+             std::chrono::milliseconds idle_time);
     ~Executor();
 
     /**
@@ -49,16 +58,7 @@ class Executor {
     template <typename F, typename... Types> bool Execute(F &&func, Types... args) {
         // Prepare "task"
         auto exec = std::bind(std::forward<F>(func), std::forward<Types>(args)...);
-
-        std::unique_lock<std::mutex> lock(this->mutex);
-        if (state != State::kRun) {
-            return false;
-        }
-
-        // Enqueue new task
-        tasks.push_back(exec);
-        empty_condition.notify_one();
-        return true;
+        return Enqueue(exec);
     }
 
 private:
@@ -68,11 +68,25 @@ private:
     Executor &operator=(const Executor &); // = delete;
     Executor &operator=(Executor &&);      // = delete;
 
+    /**
+     * Puts task to the queue and starts one more thread if needed
+     */
+    bool Enqueue(std::function<void()> task);
+
     /**
      * Main function that all pool threads are running. It polls internal task queue and execute tasks
      */
     friend void perform(Executor *executor);
 
+    /**
+     * Pool configuration
+     */
+    const std::string name;
+    const size_t low_watermark;
+    const size_t high_watermark;
+    const size_t max_queue_size;
+    const std::chrono::milliseconds idle_time;
+
     /**
      * Mutex to protect state below from concurrent modification
      */
@@ -84,9 +98,16 @@ private:
     std::condition_variable empty_condition;
 
     /**
-     * Vector of actual threads that perorm execution
+     * Conditional variable to await all threads to finish
+     */
+    std::condition_variable stop_condition;
+
+    /**
+     * Number of running threads and how many of them wait for tasks. Threads are detached, so that
+     * idle one just finishes without anybody to join it
      */
-    std::vector<std::thread> threads;
+    size_t threads;
+    size_t free_threads;
 
     /**
      * Task queue
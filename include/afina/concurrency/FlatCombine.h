@@ -1,10 +1,130 @@
 #ifndef AFINA_CONCURRENCY_FLAT_COMBINE_H
 #define AFINA_CONCURRENCY_FLAT_COMBINE_H
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/ThreadLocal.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename Op> class FlatCombine {};
+/**
+ * # Flat combining
+ * Every thread publishes operation in its own slot and one of them, the combiner, executes all the
+ * published operations in a single pass, while the rest spin waiting for their slot to be cleared.
+ * Protected data structure is touched by one thread for the whole batch, so its hot cache lines
+ * don't travel between cores on every operation as with a lock handed from thread to thread.
+ *
+ * Slots are kept by ThreadLocal, so slot of a finished thread is taken over by the next new one
+ * and combiner scans only as many slots as there were threads at once. Combiner must not throw,
+ * operation should carry its own error status instead.
+ *
+ * Thread safe implementation
+ */
+template <typename Op> class FlatCombine {
+public:
+    /**
+     * Executes count operations in the given order, always called by one thread at a time
+     */
+    using combiner_func = std::function<void(Op *const *ops, size_t count)>;
+
+    /**
+     * @param combiner function applying batches of operations
+     * @param max_batch maximum number of operations passed to the combiner at once
+     */
+    FlatCombine(combiner_func combiner, size_t max_batch = 64)
+        : _combiner(combiner), _batch(max_batch > 0 ? max_batch : 1), _owners(_batch.size()) {}
+
+    ~FlatCombine() {}
+
+    /**
+     * Executes operation and returns once it is done, by this thread or by some other
+     */
+    void Execute(Op &op) {
+        slot &own = _slots.Get();
+        own.request.store(&op, std::memory_order_release);
+
+        for (unsigned spins = 0;; spins++) {
+            if (own.request.load(std::memory_order_acquire) == nullptr) {
+                return;
+            }
+
+            // Operation was published before the lock, so combiner pass below picks it up
+            if (_lock.try_lock()) {
+                Combine();
+                _lock.unlock();
+                return;
+            }
+
+            if (spins > kSpins) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    FlatCombine(const FlatCombine &) = delete;
+    FlatCombine &operator=(const FlatCombine &) = delete;
+
+    // How long to spin before giving up the core
+    static const unsigned kSpins = 64;
+
+    /**
+     * Publication slot of a single thread
+     */
+    struct slot {
+        std::atomic<Op *> request{nullptr};
+    };
+
+    /**
+     * Collects published operations and passes them to the combiner
+     */
+    void Combine() {
+        size_t count = 0;
+
+        _slots.ForEach([this, &count](slot &s) {
+            Op *op = s.request.load(std::memory_order_acquire);
+            if (op == nullptr) {
+                return;
+            }
+
+            _batch[count] = op;
+            _owners[count] = &s;
+            if (++count == _batch.size()) {
+                Apply(count);
+                count = 0;
+            }
+        });
+
+        if (count > 0) {
+            Apply(count);
+        }
+    }
+
+    void Apply(size_t count) {
+        _combiner(&_batch[0], count);
+
+        // Owner may return and reuse operation right after its slot is cleared
+        for (size_t i = 0; i < count; i++) {
+            _owners[i]->request.store(nullptr, std::memory_order_release);
+        }
+    }
+
+    combiner_func _combiner;
+
+    // Only one thread combines at a time, it owns the batch as well
+    std::mutex _lock;
+    std::vector<Op *> _batch;
+    std::vector<slot *> _owners;
+
+    // Slot of every thread, finished threads leave theirs to the new ones
+    ThreadLocal<slot> _slots;
+};
 
 } // namespace Concurrency
 } // namespace Afina
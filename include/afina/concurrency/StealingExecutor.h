@@ -0,0 +1,88 @@
+#ifndef AFINA_CONCURRENCY_STEALING_EXECUTOR_H
+#define AFINA_CONCURRENCY_STEALING_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Work stealing thread pool
+ * Fixed number of threads, each has own lock free deque of tasks. Task submitted from the pool
+ * thread goes to the bottom of its deque and that thread takes the newest task first, so the data
+ * it has just touched is still in cache. Thread which ran out of tasks steals the oldest ones from
+ * others. Tasks from the outside go through a shared queue under mutex.
+ *
+ * Unlike Executor there is no bound on the number of queued tasks.
+ */
+class StealingExecutor {
+public:
+    StealingExecutor(std::string name, size_t size);
+    ~StealingExecutor();
+
+    /**
+     * Signal thread pool to stop, it will stop accepting new jobs, threads finish once all the
+     * queued jobs are complete.
+     *
+     * In case if await flag is true, call won't return until all threads are stopped. It must not be
+     * called with await from the pool thread
+     */
+    void Stop(bool await = false);
+
+    /**
+     * Add function to be executed on the threadpool. Returns false if pool is stopping
+     */
+    template <typename F, typename... Types> bool Execute(F &&func, Types... args) {
+        return Enqueue(std::bind(std::forward<F>(func), std::forward<Types>(args)...));
+    }
+
+private:
+    struct worker;
+    using task = std::function<void()>;
+
+    // How many times idle thread looks for a task before going to sleep
+    static const int kStealAttempts = 64;
+
+    StealingExecutor(const StealingExecutor &) = delete;
+    StealingExecutor &operator=(const StealingExecutor &) = delete;
+
+    bool Enqueue(task func);
+
+    // Main loop of the pool thread
+    void OnRun(worker &w);
+
+    // Looks for a task: own deque, shared queue, other deques
+    task *Find(worker &w);
+
+    const std::string _name;
+    std::vector<std::unique_ptr<worker>> _workers;
+    std::vector<std::thread> _threads;
+
+    // Tasks submitted from outside of the pool
+    std::mutex _inject_mutex;
+    std::deque<task *> _inject;
+
+    // Tasks queued but not taken yet
+    std::atomic<size_t> _pending;
+
+    // Idle threads sleep here
+    std::mutex _idle_mutex;
+    std::condition_variable _idle;
+    std::atomic<size_t> _sleeping;
+
+    std::atomic<bool> _running;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_STEALING_EXECUTOR_H
@@ -1,10 +1,190 @@
 #ifndef AFINA_CONCURRENCY_THREAD_LOCAL_H
 #define AFINA_CONCURRENCY_THREAD_LOCAL_H
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <stdlib.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class ThreadLocal {};
+/**
+ * # Value per thread
+ * Unlike thread_local variable every instance is reachable from any thread, so the owner updates
+ * its own value without synchronization while someone else occasionally walks over all of them,
+ * for example to sum up statistics counters. Each value lives on its own cache lines.
+ *
+ * Value is created on the first Get from a thread. Once the thread finishes its value is handed
+ * over as it is to the next thread calling Get for the first time, so the number of values is
+ * bounded by the number of threads running at once rather than by all threads ever started, while
+ * counters of finished threads are not lost. Value could be read by ForEach while the owner
+ * modifies it, so T must take care of that itself, atomics with relaxed order are enough for
+ * counters.
+ *
+ * Thread safe implementation
+ */
+template <typename T> class ThreadLocal {
+public:
+    ThreadLocal() : _id(NextId()), _slots(nullptr) {
+        std::lock_guard<std::mutex> lock(Alive().lock);
+        Alive().ids.insert(_id);
+    }
+
+    ~ThreadLocal() {
+        // Threads finishing from now on don't touch the slots anymore
+        {
+            std::lock_guard<std::mutex> lock(Alive().lock);
+            Alive().ids.erase(_id);
+        }
+
+        slot *s = _slots.load(std::memory_order_acquire);
+        while (s != nullptr) {
+            slot *next = s->next;
+            s->~slot();
+            free(s);
+            s = next;
+        }
+    }
+
+    /**
+     * Value of the calling thread, created on the first call. Isn't inlined on purpose: coroutine
+     * could be resumed on another thread, so thread local address must not be cached by the caller
+     */
+    __attribute__((noinline)) T &Get() {
+        // Most of the time thread works with a single instance
+        static thread_local uint64_t last_id = 0;
+        static thread_local slot *last_slot = nullptr;
+        if (last_id == _id) {
+            return last_slot->value;
+        }
+
+        static thread_local thread_slots own;
+        slot *&result = own.slots[_id];
+        if (result == nullptr) {
+            result = Take();
+        }
+
+        last_id = _id;
+        last_slot = result;
+        return result->value;
+    }
+
+    /**
+     * Calls f for every value, including ones left by finished threads until they are taken over
+     */
+    template <typename F> void ForEach(F f) const {
+        for (slot *s = _slots.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+            f(static_cast<const T &>(s->value));
+        }
+    }
+    template <typename F> void ForEach(F f) {
+        for (slot *s = _slots.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+            f(s->value);
+        }
+    }
+
+private:
+    ThreadLocal(const ThreadLocal &) = delete;
+    ThreadLocal &operator=(const ThreadLocal &) = delete;
+
+    static const size_t kCacheLine = 64;
+
+    // Padded up to the cache line, so that neighbour threads don't invalidate each other
+    struct alignas(kCacheLine) slot {
+        T value;
+        slot *next = nullptr;
+
+        // Cleared once the owner thread finishes
+        std::atomic<bool> owned{true};
+    };
+
+    /**
+     * Instances are told apart by a number rather than by address, which could be reused
+     */
+    static uint64_t NextId() {
+        static std::atomic<uint64_t> counter(0);
+        return ++counter;
+    }
+
+    /**
+     * Instances which are not destroyed yet. Finishing thread checks it, so that it doesn't touch
+     * slots of the instance destroyed before the thread
+     */
+    struct alive_ids {
+        std::mutex lock;
+        std::unordered_set<uint64_t> ids;
+    };
+    static alive_ids &Alive() {
+        // Never destroyed, threads could finish after static destructors have run
+        static alive_ids *result = new alive_ids();
+        return *result;
+    }
+
+    /**
+     * Slots of the calling thread, given back once it finishes
+     */
+    struct thread_slots {
+        std::unordered_map<uint64_t, slot *> slots;
+
+        ~thread_slots() {
+            std::lock_guard<std::mutex> lock(Alive().lock);
+            for (auto &it : slots) {
+                if (Alive().ids.count(it.first) != 0) {
+                    it.second->owned.store(false, std::memory_order_release);
+                }
+            }
+        }
+    };
+
+    /**
+     * Takes over slot of a finished thread if there is one, otherwise creates a new one
+     */
+    slot *Take() {
+        for (slot *s = _slots.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+            bool owned = false;
+            if (!s->owned.load(std::memory_order_relaxed) &&
+                s->owned.compare_exchange_strong(owned, true, std::memory_order_acquire)) {
+                return s;
+            }
+        }
+        return Create();
+    }
+
+    /**
+     * Allocates value for the calling thread and publishes it for ForEach
+     */
+    slot *Create() {
+        // Plain new doesn't respect alignment above the default one in C++11
+        void *mem = nullptr;
+        if (posix_memalign(&mem, kCacheLine, sizeof(slot)) != 0) {
+            throw std::bad_alloc();
+        }
+
+        slot *result;
+        try {
+            result = new (mem) slot();
+        } catch (...) {
+            free(mem);
+            throw;
+        }
+
+        result->next = _slots.load(std::memory_order_relaxed);
+        while (!_slots.compare_exchange_weak(result->next, result, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+        }
+        return result;
+    }
+
+    const uint64_t _id;
+
+    // All the values ever created, new ones are pushed to the head
+    std::atomic<slot *> _slots;
+};
 
 } // namespace Concurrency
 } // namespace Afina
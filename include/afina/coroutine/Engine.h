@@ -1,26 +1,61 @@
 #ifndef AFINA_COROUTINE_ENGINE_H
 #define AFINA_COROUTINE_ENGINE_H
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <tuple>
+#include <utility>
 
 #include <setjmp.h>
 
 namespace Afina {
 namespace Coroutine {
 
+// Forward declaration, see StackPool.h
+class StackPool;
+
 /**
  * # Entry point of coroutine library
  * Allows to run coroutine and schedule its execution. Not threadsafe
+ *
+ * Engine works in one of two modes:
+ * - by default all coroutines run on the stack of the thread called start, and switch copies
+ *   stack of the current coroutine out and the next one in. Cost grows with the stack depth
+ * - once stack size is given, every coroutine gets own stack with a guard page and switch just
+ *   swaps registers. Stacks of finished coroutines are reused
  */
 class Engine final {
 public:
     using unblocker_func = std::function<void(Engine &)>;
 
 private:
+    /**
+     * Function to be called by coroutine having own stack along with its arguments
+     */
+    struct routine_base {
+        virtual ~routine_base() {}
+        virtual void call() = 0;
+    };
+
+    template <int...> struct indices {};
+    template <int N, int... S> struct make_indices : make_indices<N - 1, N - 1, S...> {};
+    template <int... S> struct make_indices<0, S...> { typedef indices<S...> type; };
+
+    template <typename... Ta> struct routine : routine_base {
+        // Arguments passed by lvalue are kept as references, the rest is moved here
+        routine(void (*f)(Ta...), Ta &&... a) : func(f), args(std::forward<Ta>(a)...) {}
+
+        void call() override { invoke(typename make_indices<sizeof...(Ta)>::type()); }
+        template <int... S> void invoke(indices<S...>) { func(std::forward<Ta>(std::get<S>(args))...); }
+
+        void (*func)(Ta...);
+        std::tuple<Ta...> args;
+    };
+
     /**
      * A single coroutine instance which could be scheduled for execution
      * should be allocated on heap
@@ -42,6 +77,14 @@ private:
         // To include routine in the different lists, such as "alive", "blocked", e.t.c
         struct context *prev = nullptr;
         struct context *next = nullptr;
+
+        // Routine is in the "blocked" list
+        bool Blocked = false;
+
+        // Separate stack mode: function to run and saved stack pointer. Low and Hight describe
+        // stack owned by the routine
+        routine_base *Routine = nullptr;
+        void *SP = nullptr;
     } context;
 
     /**
@@ -74,6 +117,16 @@ private:
      */
     unblocker_func _unblocker;
 
+    /**
+     * Stacks of coroutines, nullptr if stacks are copied
+     */
+    std::unique_ptr<StackPool> _stacks;
+
+    /**
+     * Finished coroutine which stack is still in use, engine releases it once gets control
+     */
+    context *zombie_ctx;
+
 protected:
     /**
      * Save stack of the current coroutine in the given context
@@ -87,9 +140,40 @@ protected:
 
     static void null_unblocker(Engine &) {}
 
+    /**
+     * Moves routine from one list to another
+     */
+    static void Unlink(context *&list, context &ctx);
+    static void Link(context *&list, context &ctx);
+
+    /**
+     * Suspends current routine and passes control to the given one, nullptr means engine itself
+     */
+    void Transfer(context *to);
+
+    /**
+     * Separate stack mode: allocates stack for the routine and prepares it to start from Entry,
+     * returns false if there is no memory for it
+     */
+    bool Prepare(context &ctx);
+
+    /**
+     * Separate stack mode: schedules routines until all of them are done
+     */
+    void Loop();
+
+    /**
+     * Separate stack mode: first function called on the routine stack
+     */
+    static void Entry(void *engine);
+
 public:
-    Engine(unblocker_func unblocker = null_unblocker)
-        : StackBottom(0), cur_routine(nullptr), alive(nullptr), _unblocker(unblocker) {}
+    /**
+     * @param unblocker called once all coroutines are blocked
+     * @param stack_size if not zero, every coroutine gets own stack of that size
+     */
+    Engine(unblocker_func unblocker = null_unblocker, size_t stack_size = 0);
+    ~Engine();
     Engine(Engine &&) = delete;
     Engine(const Engine &) = delete;
 
@@ -125,6 +209,11 @@ public:
      */
     void unblock(void *coro);
 
+    /**
+     * Returns currently running coroutine, nullptr if control is outside of any
+     */
+    void *current() const { return cur_routine; }
+
     /**
      * Entry point into the engine. Prepare all internal mechanics and starts given function which is
      * considered as main.
@@ -144,7 +233,9 @@ public:
         void *pc = run(main, std::forward<Ta>(args)...);
 
         idle_ctx = new context();
-        if (setjmp(idle_ctx->Environment) > 0) {
+        if (_stacks) {
+            Loop();
+        } else if (setjmp(idle_ctx->Environment) > 0) {
             if (alive == nullptr) {
                 _unblocker(*this);
             }
@@ -174,6 +265,18 @@ public:
         // New coroutine context that carries around all information enough to call function
         context *pc = new context();
 
+        // Routine with own stack starts from the scratch, function and arguments are kept aside
+        if (_stacks) {
+            pc->Routine = new routine<Ta...>(func, std::forward<Ta>(args)...);
+            if (!Prepare(*pc)) {
+                delete pc->Routine;
+                delete pc;
+                return nullptr;
+            }
+            Link(alive, *pc);
+            return pc;
+        }
+
         // Store current state right here, i.e just before enter new coroutine, later, once it gets scheduled
         // execution starts here. Note that we have to acquire stack of the current function call to ensure
         // that function parameters will be passed along
@@ -203,7 +306,7 @@ public:
             // current coroutine finished, and the pointer is not relevant now
             cur_routine = nullptr;
             pc->prev = pc->next = nullptr;
-            delete std::get<0>(pc->Stack);
+            delete[] std::get<0>(pc->Stack);
             delete pc;
 
             // We cannot return here, as this function "returned" once already, so here we must select some other
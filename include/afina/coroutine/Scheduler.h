@@ -0,0 +1,161 @@
+#ifndef AFINA_COROUTINE_SCHEDULER_H
+#define AFINA_COROUTINE_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Afina {
+namespace Coroutine {
+
+// Forward declaration, see StackPool.h
+class StackPool;
+
+/**
+ * # Coroutines over several threads
+ * Every worker thread runs coroutines from its own queue. Coroutine which was woken up or has
+ * yielded goes to the queue of the thread it happened on, so related routines tend to stay on one
+ * core. Worker that ran out of coroutines steals half of the queue of some other worker, so load
+ * spreads over all threads. Coroutine may continue on a different thread each time it gets control.
+ *
+ * Once there is nothing to run, one of the idle workers calls poller to find out who could be
+ * woken up, the rest sleep until somebody puts coroutine into a queue.
+ *
+ * Every coroutine has own stack with a guard page, so stack size has to be enough for the deepest
+ * call chain routine makes.
+ *
+ * Thread safe implementation
+ */
+class Scheduler final {
+public:
+    /**
+     * Called by idle worker, should unblock coroutines that can proceed or return after timeout
+     * given in milliseconds
+     */
+    using poller_func = std::function<void(Scheduler &, int timeout)>;
+
+    /**
+     * @param poller called when there is nothing to run, might be empty
+     * @param stack_size stack of every coroutine
+     */
+    Scheduler(poller_func poller, size_t stack_size = 128 * 1024);
+    ~Scheduler();
+    Scheduler(Scheduler &&) = delete;
+    Scheduler(const Scheduler &) = delete;
+
+    /**
+     * Starts worker threads
+     */
+    void Start(size_t threads);
+
+    /**
+     * Signals workers to finish once there are no more coroutines
+     */
+    void Stop();
+
+    /**
+     * Waits for workers to finish, all coroutines are done after that
+     */
+    void Join();
+
+    /**
+     * Registers new coroutine and puts it into the queue, could be called from any thread.
+     * Returns coroutine handle
+     *
+     * If there is no memory for the coroutine stack even after a few attempts, coroutine is dropped
+     * without being started and on_fail is called instead, on a worker thread outside of coroutines
+     */
+    void *run(std::function<void()> func, std::function<void()> on_fail = nullptr);
+
+    /**
+     * Gives control to the next coroutine, current one goes to the end of the queue
+     */
+    void yield();
+
+    /**
+     * Suspends current coroutine until somebody unblocks it. If unblock has been already called
+     * since coroutine was woken up last time, returns immediately
+     */
+    void block();
+
+    /**
+     * Puts blocked coroutine back to the queue, could be called from any thread. If coroutine
+     * isn't blocked yet, its next block returns immediately
+     */
+    void unblock(void *coro);
+
+    /**
+     * Returns coroutine running on the calling thread, nullptr if there is none
+     */
+    static void *current();
+
+private:
+    struct fiber;
+    struct worker;
+
+    // How long idle worker polls before checking queues again
+    static const int kPollTimeout = 10;
+
+    // How many times worker tries to get stack for the fiber and how long it pauses in between
+    static const int kStackAttempts = 3;
+    static const int kStackBackoff = 1;
+
+    void OnRun(worker &w);
+
+    // Runs fiber until it gives control back and puts it wherever it belongs to
+    void Execute(worker &w, fiber *f);
+
+    // Puts fiber to the queue of the calling worker, or to the shared one if called from outside
+    void Push(fiber *f);
+
+    // Deletes fiber which is done or dropped, wakes up workers waiting for the last one
+    void Retire(fiber *f);
+
+    // Takes fiber to run: own queue, shared one, steals from others
+    fiber *Pop(worker &w);
+    fiber *Steal(worker &w);
+
+    // Returns control from fiber back to its worker
+    void Leave(int reason);
+
+    // Wakes up one sleeping worker if there is any
+    void Notify();
+
+    // First function called on the fiber stack
+    static void Entry(void *scheduler);
+
+    poller_func _poller;
+    size_t _stack_size;
+
+    std::vector<std::unique_ptr<worker>> _workers;
+    std::vector<std::thread> _threads;
+
+    // Fibers created from outside of workers
+    std::mutex _inject_mutex;
+    std::deque<fiber *> _inject;
+
+    // Number of fibers in all queues and number of fibers not finished yet
+    std::atomic<size_t> _ready;
+    std::atomic<size_t> _live;
+
+    // Some worker calls poller right now
+    std::atomic<bool> _polling;
+
+    // Idle workers sleep here
+    std::mutex _idle_mutex;
+    std::condition_variable _idle;
+    std::atomic<size_t> _sleeping;
+
+    std::atomic<bool> _stopping;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_SCHEDULER_H
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include "InsertCommand.h"
 
@@ -20,7 +21,8 @@ namespace Execute {
  */
 class Add : public InsertCommand {
 public:
-    Add(const std::string &key, uint32_t flags, int32_t expire) : InsertCommand(key, flags, expire) {}
+    Add() {}
+    Add(std::string key, uint32_t flags, int32_t expire) : InsertCommand(std::move(key), flags, expire) {}
     ~Add() {}
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include "InsertCommand.h"
 
@@ -21,7 +22,8 @@ namespace Execute {
  */
 class Append : public InsertCommand {
 public:
-    Append(const std::string &key, uint32_t flags, int32_t expire) : InsertCommand(key, flags, expire) {}
+    Append() {}
+    Append(std::string key, uint32_t flags, int32_t expire) : InsertCommand(std::move(key), flags, expire) {}
     ~Append() {}
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
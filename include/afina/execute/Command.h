@@ -9,6 +9,8 @@ class Storage;
 
 namespace Execute {
 
+class Response;
+
 /**
  *
  *
@@ -19,6 +21,13 @@ public:
     virtual ~Command() {}
 
     virtual void Execute(Storage &storage, const std::string &args, std::string &out) = 0;
+
+    /**
+     * Same as above, but result is appended to the given response. Commands that output values
+     * could override it to pin values in the storage instead of copying them, by default result
+     * of the method above gets copied
+     */
+    virtual void Execute(Storage &storage, const std::string &args, Response &out);
 };
 
 } // namespace Execute
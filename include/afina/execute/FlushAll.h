@@ -0,0 +1,29 @@
+#ifndef AFINA_EXECUTE_FLUSH_ALL_H
+#define AFINA_EXECUTE_FLUSH_ALL_H
+
+#include <string>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Remove all associations
+ * Invalidates all existing items at once. Delayed flush isn't supported, so command takes no
+ * arguments
+ *
+ * Command must write result to the output, which is always "OK"
+ */
+class FlushAll : public Command {
+public:
+    FlushAll() {}
+    ~FlushAll() {}
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_FLUSH_ALL_H
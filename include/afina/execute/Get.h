@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "Command.h"
+#include "Keys.h"
 
 namespace Afina {
 namespace Execute {
@@ -34,15 +35,35 @@ namespace Execute {
  */
 class Get : public Command {
 public:
-    Get(const std::vector<std::string> &keys) : _keys(keys) {}
+    Get(const std::vector<std::string> &keys) {
+        for (auto &key : keys) {
+            _keys.Add(key);
+        }
+    }
+    Get(const Keys &keys) : _keys(keys) {}
+    Get() {}
     ~Get() {}
 
-    inline const std::vector<std::string> &keys() const { return _keys; }
+    /**
+     * Replaces keys of the command, memory of the previous ones is reused
+     */
+    void Assign(const Keys &keys) { _keys = keys; }
+
+    /**
+     * Copy of the keys, for diagnostics and tests
+     */
+    std::vector<std::string> keys() const;
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
 
+    // Values are pinned in the storage rather than copied
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+
 private:
-    std::vector<std::string> _keys;
+    Keys _keys;
+
+    // Storage takes key as a string, it is filled in for every key and keeps its memory
+    std::string _key;
 };
 
 } // namespace Execute
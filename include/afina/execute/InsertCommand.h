@@ -2,7 +2,9 @@
 #define AFINA_EXECUTE_INSERT_COMMAND_H
 
 #include <cstdint>
+#include <ctime>
 #include <string>
+#include <utility>
 
 #include "Command.h"
 
@@ -15,17 +17,48 @@ namespace Execute {
  */
 class InsertCommand : public Command {
 public:
-    InsertCommand(const std::string &key, uint32_t flags, int32_t expire) : _key(key), _flags(flags), _expire(expire) {}
+    InsertCommand() : _flags(0), _expire(0) {}
+
+    // Key is taken by value, so that the one made by caller is moved rather than copied
+    InsertCommand(std::string key, uint32_t flags, int32_t expire)
+        : _key(std::move(key)), _flags(flags), _expire(expire) {}
     ~InsertCommand() {}
 
+    /**
+     * Fills command in with new arguments, so that the object is reused rather than made again.
+     * Key memory is kept, so the command doesn't allocate once it has seen key of that length
+     */
+    void Assign(const char *key, size_t key_size, uint32_t flags, int32_t expire) {
+        _key.assign(key, key_size);
+        _flags = flags;
+        _expire = expire;
+    }
+
     inline const std::string &key() const { return _key; }
     inline const uint32_t flags() const { return _flags; }
     inline const int32_t expire() const { return _expire; }
 
+    /**
+     * Converts exptime of memcached protocol to the absolute time storage expects: 0 means item
+     * never expires, value up to 30 days is an offset from now, anything bigger is unix time
+     * already. Negative value means item is expired immediately
+     */
+    std::time_t ExpireAt() const {
+        static const int32_t max_relative = 60 * 60 * 24 * 30;
+        if (_expire == 0) {
+            return 0;
+        } else if (_expire < 0) {
+            return 1;
+        } else if (_expire > max_relative) {
+            return _expire;
+        }
+        return std::time(nullptr) + _expire;
+    }
+
 protected:
-    const std::string _key;
-    const uint32_t _flags;
-    const int32_t _expire;
+    std::string _key;
+    uint32_t _flags;
+    int32_t _expire;
 };
 
 } // namespace Execute
@@ -0,0 +1,73 @@
+#ifndef AFINA_EXECUTE_KEYS_H
+#define AFINA_EXECUTE_KEYS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Key owned by someone else
+ * Pointer and size of the bytes, valid as long as the owner isn't modified
+ */
+struct KeyView {
+    const char *data;
+    size_t size;
+
+    std::string str() const { return std::string(data, size); }
+};
+
+/**
+ * # Keys of a command
+ * All the keys are packed one after another into a single buffer, so that any number of them takes
+ * two allocations at most instead of one per key. Clear keeps the memory, so once reused object
+ * has grown up to the usual request it doesn't allocate at all.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class Keys {
+public:
+    Keys() {}
+
+    /**
+     * Appends copy of the key
+     */
+    void Add(const char *data, size_t size) {
+        _data.append(data, size);
+        _ends.push_back(_data.size());
+    }
+    void Add(const std::string &key) { Add(key.data(), key.size()); }
+
+    /**
+     * Removes all the keys, memory stays allocated
+     */
+    void Clear() {
+        _data.clear();
+        _ends.clear();
+    }
+
+    inline size_t Size() const { return _ends.size(); }
+    inline bool Empty() const { return _ends.empty(); }
+
+    /**
+     * View of the key with given index, valid until keys are modified
+     */
+    KeyView operator[](size_t i) const {
+        size_t begin = i > 0 ? _ends[i - 1] : 0;
+        return KeyView{_data.data() + begin, _ends[i] - begin};
+    }
+
+private:
+    // Keys without separators
+    std::string _data;
+
+    // Offset of the end of every key in _data
+    std::vector<size_t> _ends;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_KEYS_H
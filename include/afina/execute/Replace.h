@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include "InsertCommand.h"
 
@@ -21,7 +22,8 @@ namespace Execute {
  */
 class Replace : public InsertCommand {
 public:
-    Replace(const std::string &key, uint32_t flags, int32_t expire) : InsertCommand(key, flags, expire) {}
+    Replace() {}
+    Replace(std::string key, uint32_t flags, int32_t expire) : InsertCommand(std::move(key), flags, expire) {}
     ~Replace() {}
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
@@ -0,0 +1,87 @@
+#ifndef AFINA_EXECUTE_RESPONSE_H
+#define AFINA_EXECUTE_RESPONSE_H
+
+#include <deque>
+#include <string>
+
+#include <sys/uio.h>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Command output
+ * Sequence of chunks to be sent to the client. Each chunk is either a piece of text owned by the
+ * response itself or a value pinned in the storage. That allows network layer to pass whole
+ * response into a single writev without copying values out of storage.
+ */
+class Response {
+public:
+    Response() : _sent(0) {}
+    ~Response() {}
+
+    Response(Response &&) = default;
+    Response &operator=(Response &&) = default;
+
+    /**
+     * Appends copy of the given text to the response
+     */
+    void Append(const char *text, size_t size);
+    void Append(const std::string &text) { Append(text.data(), text.size()); }
+
+    /**
+     * Appends value, response takes ownership of the view and keeps value pinned until it is sent
+     */
+    void Append(ValueView &&value);
+
+    /**
+     * Fills given vector with the bytes that are not sent yet, returns number of entries filled
+     */
+    size_t Fill(struct iovec *iov, size_t iov_size) const;
+
+    /**
+     * Marks given number of bytes as sent, pinned values are released as soon as they are sent
+     */
+    void Consume(size_t size);
+
+    /**
+     * Returns true if there is nothing to send
+     */
+    inline bool Empty() const { return _chunks.empty(); }
+
+    /**
+     * Drop all chunks and release all pinned values
+     */
+    void Clear();
+
+private:
+    Response(const Response &) = delete;
+    Response &operator=(const Response &) = delete;
+
+    struct chunk {
+        // Text chunk is a range in the _text buffer
+        size_t text_begin;
+        size_t text_size;
+
+        // Pinned value chunk
+        ValueView value;
+
+        inline size_t size() const { return value.data() != nullptr ? value.size() : text_size; }
+    };
+
+    // Storage for all text chunks
+    std::string _text;
+
+    // Chunks to be sent
+    std::deque<chunk> _chunks;
+
+    // Number of bytes of the first chunk already sent
+    size_t _sent;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_RESPONSE_H
@@ -0,0 +1,85 @@
+#include "Arena.h"
+
+#include <new>
+#include <stdexcept>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Allocator {
+
+// See Arena.h
+Arena::Arena(size_t slab_size, size_t batch_slabs)
+    : _slab_size(slab_size), _batch_slabs(batch_slabs), _free(0), _batch_pos(nullptr), _batch_end(nullptr) {
+    size_t page = sysconf(_SC_PAGESIZE);
+    if ((slab_size & (slab_size - 1)) != 0 || slab_size % page != 0 || batch_slabs == 0) {
+        throw std::invalid_argument("Slab size must be power of two multiple of the page size");
+    }
+}
+
+// See Arena.h
+Arena::~Arena() {
+    for (char *batch : _batches) {
+        munmap(batch, _slab_size * _batch_slabs);
+    }
+}
+
+// See Arena.h
+void *Arena::Map() {
+    const uintptr_t mask = _slab_size - 1;
+
+    // Slab taken from the stack by another thread could be already overwritten, then next is a
+    // garbage but CAS fails anyway since counter was changed
+    uintptr_t head = _free.load(std::memory_order_acquire);
+    while ((head & ~mask) != 0) {
+        free_slab *top = reinterpret_cast<free_slab *>(head & ~mask);
+        uintptr_t next = top->next.load(std::memory_order_relaxed);
+        if (_free.compare_exchange_weak(head, next | ((head + 1) & mask), std::memory_order_acquire,
+                                        std::memory_order_acquire)) {
+            return top;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_batch_lock);
+    if (_batch_pos == _batch_end) {
+        // Map one extra slab to be able to align the batch, surplus is given back right away
+        size_t size = _slab_size * _batch_slabs;
+        char *mem = static_cast<char *>(
+            mmap(nullptr, size + _slab_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (mem == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        char *batch = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(mem) + mask) & ~mask);
+        if (batch != mem) {
+            munmap(mem, batch - mem);
+        }
+        if (batch + size != mem + size + _slab_size) {
+            munmap(batch + size, mem + size + _slab_size - (batch + size));
+        }
+
+        _batches.push_back(batch);
+        _batch_pos = batch;
+        _batch_end = batch + size;
+    }
+
+    void *result = _batch_pos;
+    _batch_pos += _slab_size;
+    return result;
+}
+
+// See Arena.h
+void Arena::Unmap(void *slab) {
+    const uintptr_t mask = _slab_size - 1;
+
+    free_slab *top = new (slab) free_slab;
+    uintptr_t head = _free.load(std::memory_order_relaxed);
+    do {
+        top->next.store(head & ~mask, std::memory_order_relaxed);
+    } while (!_free.compare_exchange_weak(head, reinterpret_cast<uintptr_t>(slab) | ((head + 1) & mask),
+                                          std::memory_order_release, std::memory_order_relaxed));
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,73 @@
+#ifndef AFINA_ALLOCATOR_ARENA_H
+#define AFINA_ALLOCATOR_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Source of slabs shared by all threads
+ * Hands out slabs of fixed power of two size aligned on their size, so header of the slab could
+ * be found from any address inside of it by mask. Memory is mapped from the system by batches of
+ * slabs and never returned back until arena gets destroyed.
+ *
+ * Returned slabs are kept in the lock-free stack. Since slabs are aligned, low bits of the stack
+ * head are free and keep counter of the operations, that protects stack from ABA problem. Mutex
+ * is taken only to cut new slab from the batch.
+ *
+ * Thread safe implementation
+ */
+class Arena {
+public:
+    /**
+     * @param slab_size size of the slab, must be power of two and multiple of the page size
+     * @param batch_slabs number of slabs mapped from the system at once
+     */
+    Arena(size_t slab_size = 64 * 1024, size_t batch_slabs = 64);
+    ~Arena();
+
+    /**
+     * Returns slab aligned on its size, throws std::bad_alloc if system runs out of memory
+     */
+    void *Map();
+
+    /**
+     * Gives slab back to be reused by any thread
+     */
+    void Unmap(void *slab);
+
+    size_t SlabSize() const { return _slab_size; }
+
+private:
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    // Header of the slab in the free stack
+    struct free_slab {
+        std::atomic<uintptr_t> next;
+    };
+
+    const size_t _slab_size;
+    const size_t _batch_slabs;
+
+    // Head of the free stack: address of the top slab combined with ABA counter in low bits
+    std::atomic<uintptr_t> _free;
+
+    // Unused tail of the last mapped batch
+    std::mutex _batch_lock;
+    char *_batch_pos;
+    char *_batch_end;
+
+    // All batches mapped so far
+    std::vector<char *> _batches;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_ARENA_H
@@ -0,0 +1,232 @@
+#include "Mempool.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+
+#include <stdlib.h>
+
+namespace Afina {
+namespace Allocator {
+
+// Header of the slab, objects follow it up to the end of the slab
+struct Mempool::slab {
+    Mempool *pool;
+
+    // Links in the partial or full list of the pool
+    slab *prev;
+    slab *next;
+    bool partial;
+
+    // Objects freed by the owner
+    void *free_list;
+
+    // Part of the slab which was never given out
+    char *unused;
+    char *end;
+
+    // Number of objects which are not in the free list
+    size_t used;
+
+    // Stack of objects freed by other threads, the lowest bit is set once slab is queued to
+    // the pool. Written by other threads, so it lives in its own cache line
+    alignas(64) std::atomic<uintptr_t> remote;
+    slab *next_pending;
+};
+
+namespace {
+
+// Objects are aligned as malloc does
+inline size_t ObjectAlign(size_t size) { return (size + 15) & ~size_t(15); }
+
+inline void *&NextOf(void *object) { return *static_cast<void **>(object); }
+
+} // namespace
+
+// See Mempool.h
+Mempool::Mempool(SlabCache &cache, size_t object_size)
+    : _cache(cache), _object_size(ObjectAlign(std::max(object_size, sizeof(void *)))), _partial(nullptr),
+      _full(nullptr), _slabs(0), _pending(nullptr) {
+    if (ObjectAlign(sizeof(slab)) + _object_size > _cache.SlabSize()) {
+        throw std::invalid_argument("Object doesn't fit the slab");
+    }
+}
+
+// See Mempool.h
+void *Mempool::operator new(size_t size) {
+    void *result = nullptr;
+    if (posix_memalign(&result, alignof(Mempool), size) != 0) {
+        throw std::bad_alloc();
+    }
+    return result;
+}
+
+// See Mempool.h
+void Mempool::operator delete(void *ptr) { free(ptr); }
+
+// See Mempool.h
+Mempool::~Mempool() {
+    Collect();
+    for (slab *list : {_partial, _full}) {
+        while (list != nullptr) {
+            slab *next = list->next;
+            list->~slab();
+            _cache.Put(list);
+            list = next;
+        }
+    }
+}
+
+// See Mempool.h
+void *Mempool::Alloc() {
+    if (_partial == nullptr) {
+        Collect();
+        if (_partial == nullptr) {
+            NewSlab();
+        }
+    }
+
+    slab *s = _partial;
+    void *result;
+    if (s->free_list != nullptr) {
+        result = s->free_list;
+        s->free_list = NextOf(result);
+    } else {
+        result = s->unused;
+        s->unused += _object_size;
+    }
+    s->used++;
+
+    if (s->free_list == nullptr && s->unused + _object_size > s->end) {
+        Unlink(_partial, s);
+        Link(_full, s);
+        s->partial = false;
+    }
+    return result;
+}
+
+// See Mempool.h
+void Mempool::Free(void *object) {
+    slab *s = SlabOf(object, _cache.SlabSize());
+    NextOf(object) = s->free_list;
+    s->free_list = object;
+    s->used--;
+    Freed(s);
+}
+
+// See Mempool.h
+void Mempool::FreeRemote(void *object) {
+    slab *s = SlabOf(object, _cache.SlabSize());
+
+    uintptr_t head = s->remote.load(std::memory_order_relaxed);
+    do {
+        NextOf(object) = reinterpret_cast<void *>(head & ~uintptr_t(1));
+    } while (!s->remote.compare_exchange_weak(head, reinterpret_cast<uintptr_t>(object) | 1,
+                                              std::memory_order_release, std::memory_order_relaxed));
+
+    // Slab can't go away until owner collects the object, and it can't do so before slab is queued
+    if ((head & 1) == 0) {
+        slab *top = _pending.load(std::memory_order_relaxed);
+        do {
+            s->next_pending = top;
+        } while (!_pending.compare_exchange_weak(top, s, std::memory_order_release, std::memory_order_relaxed));
+    }
+}
+
+// See Mempool.h
+Mempool *Mempool::Owner(void *object, size_t slab_size) { return SlabOf(object, slab_size)->pool; }
+
+// See Mempool.h
+void Mempool::Trim() {
+    Collect();
+    for (slab *s = _partial; s != nullptr;) {
+        slab *next = s->next;
+        if (s->used == 0) {
+            ReleaseSlab(s);
+        }
+        s = next;
+    }
+}
+
+void Mempool::Collect() {
+    slab *s = _pending.exchange(nullptr, std::memory_order_acquire);
+    while (s != nullptr) {
+        // Slab could be queued again by the next remote free as soon as its stack is taken
+        slab *next = s->next_pending;
+
+        void *object = reinterpret_cast<void *>(s->remote.exchange(0, std::memory_order_acquire) & ~uintptr_t(1));
+        while (object != nullptr) {
+            void *next_object = NextOf(object);
+            NextOf(object) = s->free_list;
+            s->free_list = object;
+            s->used--;
+            object = next_object;
+        }
+
+        Freed(s);
+        s = next;
+    }
+}
+
+void Mempool::Freed(slab *s) {
+    if (!s->partial) {
+        Unlink(_full, s);
+        Link(_partial, s);
+        s->partial = true;
+    }
+
+    // Keep the last partial slab to avoid bouncing it to the cache and back
+    if (s->used == 0 && (s != _partial || s->next != nullptr)) {
+        ReleaseSlab(s);
+    }
+}
+
+void Mempool::NewSlab() {
+    char *mem = static_cast<char *>(_cache.Get());
+
+    slab *s = new (mem) slab();
+    s->pool = this;
+    s->prev = s->next = nullptr;
+    s->partial = true;
+    s->free_list = nullptr;
+    s->unused = mem + ObjectAlign(sizeof(slab));
+    s->end = mem + _cache.SlabSize();
+    s->used = 0;
+    s->remote.store(0, std::memory_order_relaxed);
+    s->next_pending = nullptr;
+
+    Link(_partial, s);
+    _slabs++;
+}
+
+void Mempool::ReleaseSlab(slab *s) {
+    Unlink(_partial, s);
+    s->~slab();
+    _cache.Put(s);
+    _slabs--;
+}
+
+void Mempool::Link(slab *&list, slab *s) {
+    s->prev = nullptr;
+    s->next = list;
+    if (list != nullptr) {
+        list->prev = s;
+    }
+    list = s;
+}
+
+void Mempool::Unlink(slab *&list, slab *s) {
+    if (s->prev != nullptr) {
+        s->prev->next = s->next;
+    } else {
+        list = s->next;
+    }
+    if (s->next != nullptr) {
+        s->next->prev = s->prev;
+    }
+    s->prev = s->next = nullptr;
+}
+
+} // namespace Allocator
+} // namespace Afina
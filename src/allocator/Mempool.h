@@ -0,0 +1,106 @@
+#ifndef AFINA_ALLOCATOR_MEMPOOL_H
+#define AFINA_ALLOCATOR_MEMPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "SlabCache.h"
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Pool of objects of the same size
+ * Cuts slabs taken from the thread cache into objects of fixed size. Each slab keeps its own free
+ * list, slabs which have free objects are linked into the partial list so allocation and free by
+ * the owner thread are O(1) and never synchronized. Slab which becomes empty is given back to the
+ * cache unless it is the last partial one.
+ *
+ * Any other thread could return object by FreeRemote: object is pushed to the lock-free stack of
+ * its slab, the first pusher after the owner took the stack also queues slab to the pool. Owner
+ * collects queued slabs once there are no free objects left, so remote frees cost the owner
+ * nothing until it actually needs memory.
+ *
+ * Everything but FreeRemote is NOT thread safe, methods must be called by the owner thread
+ */
+class Mempool {
+public:
+    Mempool(SlabCache &cache, size_t object_size);
+    ~Mempool();
+
+    // Plain new doesn't respect alignment above the default one in C++11
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
+
+    /**
+     * Returns object of the pool size, throws std::bad_alloc if system runs out of memory
+     */
+    void *Alloc();
+
+    /**
+     * Returns object allocated by this pool to it, must be called by the owner thread
+     */
+    void Free(void *object);
+
+    /**
+     * Returns object allocated by this pool to it from any thread
+     */
+    void FreeRemote(void *object);
+
+    /**
+     * Returns pool the object was allocated by
+     */
+    static Mempool *Owner(void *object, size_t slab_size);
+
+    /**
+     * Collects objects freed by other threads and gives all empty slabs back to the cache
+     */
+    void Trim();
+
+    size_t ObjectSize() const { return _object_size; }
+
+    // Number of slabs taken by the pool
+    size_t Slabs() const { return _slabs; }
+
+private:
+    Mempool(const Mempool &) = delete;
+    Mempool &operator=(const Mempool &) = delete;
+
+    struct slab;
+
+    static inline slab *SlabOf(void *object, size_t slab_size) {
+        return reinterpret_cast<slab *>(reinterpret_cast<uintptr_t>(object) & ~uintptr_t(slab_size - 1));
+    }
+
+    // Takes objects freed by other threads back to the slabs free lists
+    void Collect();
+
+    // Moves slab to the partial list once it has free objects, releases it if it became empty
+    void Freed(slab *s);
+
+    void NewSlab();
+    void ReleaseSlab(slab *s);
+
+    void Link(slab *&list, slab *s);
+    void Unlink(slab *&list, slab *s);
+
+    SlabCache &_cache;
+    const size_t _object_size;
+
+    // Slabs having free objects, allocation goes from the first one
+    slab *_partial;
+
+    // Slabs without free objects
+    slab *_full;
+
+    size_t _slabs;
+
+    // Slabs queued by remote frees are written by other threads, keep them away from the rest
+    alignas(64) std::atomic<slab *> _pending;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_MEMPOOL_H
@@ -3,12 +3,22 @@
 namespace Afina {
 namespace Allocator {
 
-Pointer::Pointer() {}
-Pointer::Pointer(const Pointer &) {}
-Pointer::Pointer(Pointer &&) {}
+Pointer::Pointer() : _descriptor(nullptr) {}
+Pointer::Pointer(const Pointer &other) : _descriptor(other._descriptor) {}
+Pointer::Pointer(Pointer &&other) : _descriptor(other._descriptor) { other._descriptor = nullptr; }
 
-Pointer &Pointer::operator=(const Pointer &) { return *this; }
-Pointer &Pointer::operator=(Pointer &&) { return *this; }
+Pointer &Pointer::operator=(const Pointer &other) {
+    _descriptor = other._descriptor;
+    return *this;
+}
+
+Pointer &Pointer::operator=(Pointer &&other) {
+    if (this != &other) {
+        _descriptor = other._descriptor;
+        other._descriptor = nullptr;
+    }
+    return *this;
+}
 
 } // namespace Allocator
 } // namespace Afina
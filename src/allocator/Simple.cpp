@@ -1,40 +1,276 @@
 #include <afina/allocator/Simple.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
 #include <afina/allocator/Pointer.h>
 
 namespace Afina {
 namespace Allocator {
 
-Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {}
-
-/**
- * TODO: semantics
- * @param N size_t
- */
-Pointer Simple::alloc(size_t N) { return Pointer(); }
-
-/**
- * TODO: semantics
- * @param p Pointer
- * @param N size_t
- */
-void Simple::realloc(Pointer &p, size_t N) {}
-
-/**
- * TODO: semantics
- * @param p Pointer
- */
-void Simple::free(Pointer &p) {}
-
-/**
- * TODO: semantics
- */
-void Simple::defrag() {}
-
-/**
- * TODO: semantics
- */
-std::string Simple::dump() const { return ""; }
+namespace {
+
+// Every block starts at this alignment
+const size_t kAlign = 16;
+
+inline uintptr_t AlignUp(uintptr_t value) { return (value + kAlign - 1) & ~uintptr_t(kAlign - 1); }
+
+// Descriptors table ends here
+inline void **AreaEnd(void *base, size_t size) {
+    return reinterpret_cast<void **>((reinterpret_cast<uintptr_t>(base) + size) & ~uintptr_t(sizeof(void *) - 1));
+}
+
+} // namespace
+
+// Header of each block, followed by the block data
+struct Simple::block {
+    // Size of the data, multiple of kAlign
+    size_t size;
+
+    // Descriptor of the used block, nullptr for the free one
+    void **descriptor;
+
+    inline char *data() { return reinterpret_cast<char *>(this + 1); }
+    inline block *next() { return reinterpret_cast<block *>(data() + size); }
+
+    // Free block keeps links of the free list in its data
+    inline block *&prev_free() { return reinterpret_cast<block **>(data())[0]; }
+    inline block *&next_free() { return reinterpret_cast<block **>(data())[1]; }
+
+    static block *of(void *data) { return reinterpret_cast<block *>(data) - 1; }
+};
+
+namespace {
+
+// Data of any block must be able to keep free list links
+inline size_t BlockSize(size_t size) { return AlignUp(std::max(size, 2 * sizeof(void *))); }
+
+} // namespace
+
+Simple::Simple(void *base, size_t size)
+    : _base(base), _base_len(size), _free_descriptors(nullptr), _free_blocks(nullptr), _used(0) {
+    _descriptors = AreaEnd(base, size);
+    _begin = _top = reinterpret_cast<char *>(AlignUp(reinterpret_cast<uintptr_t>(base)));
+    if (_begin > reinterpret_cast<char *>(_descriptors)) {
+        _begin = _top = reinterpret_cast<char *>(_descriptors);
+    }
+}
+
+// See Simple.h
+Pointer Simple::alloc(size_t N) {
+    void **descriptor = TakeDescriptor();
+
+    block *b;
+    try {
+        b = TakeBlock(BlockSize(N));
+    } catch (AllocError &) {
+        ReleaseDescriptor(descriptor);
+        throw;
+    }
+
+    b->descriptor = descriptor;
+    *descriptor = b->data();
+    _used += sizeof(block) + b->size;
+    return Pointer(descriptor);
+}
+
+// See Simple.h
+void Simple::realloc(Pointer &p, size_t N) {
+    if (p._descriptor == nullptr) {
+        p = alloc(N);
+        return;
+    }
+
+    size_t size = BlockSize(N);
+    block *b = block::of(*p._descriptor);
+    size_t old_size = b->size;
+    if (size <= b->size) {
+        Split(b, size);
+        _used -= old_size - b->size;
+        return;
+    }
+
+    // Try to grow in place over free blocks which follow
+    for (block *next = b->next(); b->size < size && reinterpret_cast<char *>(next) != _top &&
+                                  next->descriptor == nullptr;
+         next = b->next()) {
+        UnlinkFree(next);
+        b->size += sizeof(block) + next->size;
+    }
+    if (size <= b->size) {
+        Split(b, size);
+        _used += b->size - old_size;
+        return;
+    }
+
+    // ... or over unused space if the block is the last one
+    if (reinterpret_cast<char *>(b->next()) == _top && Unused() >= size - b->size) {
+        _top += size - b->size;
+        b->size = size;
+        _used += size - old_size;
+        return;
+    }
+
+    block *moved;
+    try {
+        moved = TakeBlock(size);
+    } catch (AllocError &) {
+        // Free blocks merged above stay a part of the block, so that nothing is lost
+        _used += b->size - old_size;
+        throw;
+    }
+    std::memcpy(moved->data(), b->data(), b->size);
+    moved->descriptor = b->descriptor;
+    *moved->descriptor = moved->data();
+    _used += moved->size - old_size;
+    ReleaseBlock(b);
+}
+
+// See Simple.h
+void Simple::free(Pointer &p) {
+    if (p._descriptor == nullptr) {
+        return;
+    }
+
+    if (p._descriptor < _descriptors || p._descriptor >= AreaEnd(_base, _base_len)) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to the allocator");
+    }
+
+    block *b = block::of(*p._descriptor);
+    _used -= sizeof(block) + b->size;
+    ReleaseBlock(b);
+    ReleaseDescriptor(p._descriptor);
+    p._descriptor = nullptr;
+}
+
+// See Simple.h
+void Simple::defrag() {
+    char *dst = _begin;
+    for (char *pos = _begin; pos != _top;) {
+        block *b = reinterpret_cast<block *>(pos);
+        size_t total = sizeof(block) + b->size;
+
+        if (b->descriptor != nullptr) {
+            if (pos != dst) {
+                std::memmove(dst, pos, total);
+                b = reinterpret_cast<block *>(dst);
+                *b->descriptor = b->data();
+            }
+            dst += total;
+        }
+        pos += total;
+    }
+
+    _top = dst;
+    _free_blocks = nullptr;
+}
+
+// See Simple.h
+size_t Simple::available() const { return reinterpret_cast<char *>(_descriptors) - _begin - _used; }
+
+// See Simple.h
+size_t Simple::footprint(size_t N) { return sizeof(block) + BlockSize(N) + sizeof(void *); }
+
+// See Simple.h
+std::string Simple::dump() const {
+    std::stringstream out;
+    out << "blocks: " << (_top - _begin) << " bytes, unused: " << Unused() << " bytes" << std::endl;
+    for (char *pos = _begin; pos != _top;) {
+        block *b = reinterpret_cast<block *>(pos);
+        out << (pos - _begin) << ": " << b->size << (b->descriptor != nullptr ? " used" : " free") << std::endl;
+        pos += sizeof(block) + b->size;
+    }
+    return out.str();
+}
+
+Simple::block *Simple::TakeBlock(size_t size) {
+    for (block *b = _free_blocks; b != nullptr; b = b->next_free()) {
+        if (b->size >= size) {
+            UnlinkFree(b);
+            Split(b, size);
+            return b;
+        }
+    }
+
+    if (Unused() < sizeof(block) + size) {
+        throw AllocError(AllocErrorType::NoMemory, "No free block of the requested size");
+    }
+
+    block *b = reinterpret_cast<block *>(_top);
+    b->size = size;
+    b->descriptor = nullptr;
+    _top += sizeof(block) + size;
+    return b;
+}
+
+// There are no links to the previous block, so only following free blocks are merged. Anything
+// else is left for defrag
+void Simple::ReleaseBlock(block *b) {
+    b->descriptor = nullptr;
+    for (block *next = b->next(); reinterpret_cast<char *>(next) != _top && next->descriptor == nullptr;
+         next = b->next()) {
+        UnlinkFree(next);
+        b->size += sizeof(block) + next->size;
+    }
+
+    if (reinterpret_cast<char *>(b->next()) == _top) {
+        _top = reinterpret_cast<char *>(b);
+    } else {
+        LinkFree(b);
+    }
+}
+
+void Simple::Split(block *b, size_t size) {
+    if (b->size < size + sizeof(block) + BlockSize(0)) {
+        return;
+    }
+
+    block *rest = reinterpret_cast<block *>(b->data() + size);
+    rest->size = b->size - size - sizeof(block);
+    b->size = size;
+    ReleaseBlock(rest);
+}
+
+void Simple::LinkFree(block *b) {
+    b->prev_free() = nullptr;
+    b->next_free() = _free_blocks;
+    if (_free_blocks != nullptr) {
+        _free_blocks->prev_free() = b;
+    }
+    _free_blocks = b;
+}
+
+void Simple::UnlinkFree(block *b) {
+    if (b->prev_free() != nullptr) {
+        b->prev_free()->next_free() = b->next_free();
+    } else {
+        _free_blocks = b->next_free();
+    }
+    if (b->next_free() != nullptr) {
+        b->next_free()->prev_free() = b->prev_free();
+    }
+}
+
+void **Simple::TakeDescriptor() {
+    if (_free_descriptors != nullptr) {
+        void **result = _free_descriptors;
+        _free_descriptors = static_cast<void **>(*result);
+        return result;
+    }
+
+    if (Unused() < sizeof(void *)) {
+        throw AllocError(AllocErrorType::NoMemory, "No space for descriptor");
+    }
+    return --_descriptors;
+}
+
+void Simple::ReleaseDescriptor(void **descriptor) {
+    *descriptor = _free_descriptors;
+    _free_descriptors = descriptor;
+}
 
 } // namespace Allocator
 } // namespace Afina
@@ -0,0 +1,49 @@
+#include "SlabCache.h"
+
+namespace Afina {
+namespace Allocator {
+
+// See SlabCache.h
+SlabCache::SlabCache(Arena &arena, size_t max_cached)
+    : _arena(arena), _max_cached(max_cached), _cached(nullptr), _cached_count(0) {}
+
+// See SlabCache.h
+SlabCache::~SlabCache() { Flush(); }
+
+// See SlabCache.h
+void *SlabCache::Get() {
+    if (_cached == nullptr) {
+        return _arena.Map();
+    }
+
+    cached_slab *result = _cached;
+    _cached = result->next;
+    _cached_count--;
+    return result;
+}
+
+// See SlabCache.h
+void SlabCache::Put(void *slab) {
+    if (_cached_count == _max_cached) {
+        _arena.Unmap(slab);
+        return;
+    }
+
+    cached_slab *cached = static_cast<cached_slab *>(slab);
+    cached->next = _cached;
+    _cached = cached;
+    _cached_count++;
+}
+
+// See SlabCache.h
+void SlabCache::Flush() {
+    while (_cached != nullptr) {
+        cached_slab *next = _cached->next;
+        _arena.Unmap(_cached);
+        _cached = next;
+    }
+    _cached_count = 0;
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,59 @@
+#ifndef AFINA_ALLOCATOR_SLAB_CACHE_H
+#define AFINA_ALLOCATOR_SLAB_CACHE_H
+
+#include <cstddef>
+
+#include "Arena.h"
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Thread local cache of slabs
+ * Keeps a few empty slabs at hand, so that pools of the thread could exchange slabs without
+ * touching shared arena. Slabs beyond the limit go back to the arena.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class SlabCache {
+public:
+    SlabCache(Arena &arena, size_t max_cached = 4);
+    ~SlabCache();
+
+    /**
+     * Returns empty slab, throws std::bad_alloc if system runs out of memory
+     */
+    void *Get();
+
+    /**
+     * Takes slab which isn't used anymore
+     */
+    void Put(void *slab);
+
+    /**
+     * Gives all cached slabs back to the arena
+     */
+    void Flush();
+
+    size_t SlabSize() const { return _arena.SlabSize(); }
+
+private:
+    SlabCache(const SlabCache &) = delete;
+    SlabCache &operator=(const SlabCache &) = delete;
+
+    // Header of the cached slab
+    struct cached_slab {
+        cached_slab *next;
+    };
+
+    Arena &_arena;
+    const size_t _max_cached;
+
+    cached_slab *_cached;
+    size_t _cached_count;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_SLAB_CACHE_H
@@ -0,0 +1,145 @@
+#include <afina/allocator/Small.h>
+
+#include <memory>
+#include <mutex>
+
+#include "Arena.h"
+#include "Mempool.h"
+#include "SlabCache.h"
+
+namespace Afina {
+namespace Allocator {
+
+namespace {
+
+const size_t kSlabSize = 64 * 1024;
+
+// Sizes up to 256 bytes go by 16 bytes, then there are 4 classes between powers of two
+const size_t kClasses = 16 + 4 * 5;
+
+inline size_t ClassOf(size_t size) {
+    if (size <= 256) {
+        return size == 0 ? 0 : (size - 1) >> 4;
+    }
+
+    size_t n = size - 1;
+    size_t lg = 63 - __builtin_clzll(n);
+    return 16 + (lg - 8) * 4 + ((n >> (lg - 2)) & 3);
+}
+
+inline size_t ClassSize(size_t cls) {
+    if (cls < 16) {
+        return (cls + 1) << 4;
+    }
+
+    size_t lg = 8 + (cls - 16) / 4;
+    return (size_t(1) << lg) + ((cls - 16) % 4 + 1) * (size_t(1) << (lg - 2));
+}
+
+// Pools used by a single thread at a time
+struct ThreadCache {
+    ThreadCache(Arena &arena) : slabs(arena), next_idle(nullptr) {
+        for (size_t cls = 0; cls < kClasses; cls++) {
+            pools[cls].reset(new Mempool(slabs, ClassSize(cls)));
+        }
+    }
+
+    SlabCache slabs;
+    std::unique_ptr<Mempool> pools[kClasses];
+    ThreadCache *next_idle;
+};
+
+// State shared by all threads. It is never destroyed, since memory could be released by static
+// destructors of other modules or by threads which outlive main
+struct Registry {
+    Registry() : arena(kSlabSize), idle(nullptr) {}
+
+    Arena arena;
+
+    // Caches left by finished threads
+    std::mutex lock;
+    ThreadCache *idle;
+};
+
+Registry &Shared() {
+    static Registry *registry = new Registry();
+    return *registry;
+}
+
+// Cache of the thread, it is given back to the registry once thread finishes
+struct CacheHolder {
+    CacheHolder() : cache(nullptr) {}
+
+    ~CacheHolder() {
+        if (cache == nullptr) {
+            return;
+        }
+
+        for (auto &pool : cache->pools) {
+            pool->Trim();
+        }
+        cache->slabs.Flush();
+
+        Registry &registry = Shared();
+        std::lock_guard<std::mutex> lock(registry.lock);
+        cache->next_idle = registry.idle;
+        registry.idle = cache;
+        cache = nullptr;
+    }
+
+    ThreadCache *cache;
+};
+
+thread_local CacheHolder holder;
+
+ThreadCache &Current() {
+    if (holder.cache != nullptr) {
+        return *holder.cache;
+    }
+
+    Registry &registry = Shared();
+    {
+        std::lock_guard<std::mutex> lock(registry.lock);
+        if (registry.idle != nullptr) {
+            holder.cache = registry.idle;
+            registry.idle = holder.cache->next_idle;
+        }
+    }
+
+    if (holder.cache == nullptr) {
+        holder.cache = new ThreadCache(registry.arena);
+    }
+    return *holder.cache;
+}
+
+} // namespace
+
+// See Small.h
+void *Small::Alloc(size_t size) {
+    if (size > kMaxSize) {
+        return ::operator new(size);
+    }
+    return Current().pools[ClassOf(size)]->Alloc();
+}
+
+// See Small.h
+void Small::Free(void *ptr, size_t size) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    if (size > kMaxSize) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    Mempool *owner = Mempool::Owner(ptr, kSlabSize);
+    if (holder.cache != nullptr && holder.cache->pools[ClassOf(size)].get() == owner) {
+        owner->Free(ptr);
+    } else {
+        owner->FreeRemote(ptr);
+    }
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,148 @@
+#ifndef AFINA_CONCURRENCY_CHASE_LEV_DEQUE_H
+#define AFINA_CONCURRENCY_CHASE_LEV_DEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Work stealing deque
+ * Dynamic circular work-stealing deque by Chase and Lev, with memory orders from "Correct and
+ * Efficient Work-Stealing for Weak Memory Models" by Le et al. Owner pushes and takes items at the
+ * bottom without any locks, other threads steal from the top, only the last item is contended by
+ * compare and swap.
+ *
+ * Deque keeps pointers and doesn't own them. Arrays replaced on growth are kept until deque is
+ * destroyed, because thief could still read from an old one.
+ *
+ * Push and Take could be called by owner thread only, Steal by any thread
+ */
+template <typename T> class ChaseLevDeque {
+public:
+    explicit ChaseLevDeque(size_t capacity = 64) : _top(0), _bottom(0) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _arrays.emplace_back(new Array(size));
+        _array.store(_arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    /**
+     * Puts item to the bottom
+     */
+    void Push(T *item) {
+        int64_t b = _bottom.load(std::memory_order_relaxed);
+        int64_t t = _top.load(std::memory_order_acquire);
+        Array *a = _array.load(std::memory_order_relaxed);
+        if (b - t > int64_t(a->Capacity()) - 1) {
+            _arrays.emplace_back(a->Grow(b, t));
+            a = _arrays.back().get();
+            _array.store(a, std::memory_order_release);
+        }
+
+        a->Put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Takes item from the bottom, the one pushed last. Returns nullptr if deque is empty
+     */
+    T *Take() {
+        int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+        Array *a = _array.load(std::memory_order_relaxed);
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = _top.load(std::memory_order_relaxed);
+
+        T *result = nullptr;
+        if (t <= b) {
+            result = a->Get(b);
+            if (t == b) {
+                // Last item, thieves race for it as well
+                if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    result = nullptr;
+                }
+                _bottom.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            _bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    /**
+     * Takes item from the top, the oldest one. Returns nullptr if deque is empty or somebody else
+     * took the item first
+     */
+    T *Steal() {
+        int64_t t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = _bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+
+        Array *a = _array.load(std::memory_order_acquire);
+        T *result = a->Get(t);
+        if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return result;
+    }
+
+    /**
+     * Approximate number of items, exact if called by owner with no thieves around
+     */
+    size_t Size() const {
+        int64_t b = _bottom.load(std::memory_order_relaxed);
+        int64_t t = _top.load(std::memory_order_relaxed);
+        return b > t ? size_t(b - t) : 0;
+    }
+
+private:
+    ChaseLevDeque(const ChaseLevDeque &) = delete;
+    ChaseLevDeque &operator=(const ChaseLevDeque &) = delete;
+
+    /**
+     * Ring of items, indices grow forever and are wrapped by mask
+     */
+    class Array {
+    public:
+        explicit Array(size_t capacity) : _mask(capacity - 1), _items(new std::atomic<T *>[capacity]) {}
+
+        size_t Capacity() const { return _mask + 1; }
+        T *Get(int64_t i) const { return _items[i & _mask].load(std::memory_order_relaxed); }
+        void Put(int64_t i, T *item) { _items[i & _mask].store(item, std::memory_order_relaxed); }
+
+        Array *Grow(int64_t bottom, int64_t top) const {
+            Array *result = new Array(Capacity() * 2);
+            for (int64_t i = top; i < bottom; i++) {
+                result->Put(i, Get(i));
+            }
+            return result;
+        }
+
+    private:
+        size_t _mask;
+        std::unique_ptr<std::atomic<T *>[]> _items;
+    };
+
+    std::atomic<int64_t> _top;
+    std::atomic<int64_t> _bottom;
+    std::atomic<Array *> _array;
+
+    // Current array and all the previous ones, touched by owner only
+    std::vector<std::unique_ptr<Array>> _arrays;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_CHASE_LEV_DEQUE_H
@@ -1,5 +1,105 @@
 #include <afina/concurrency/Executor.h>
 
+#include <algorithm>
+#include <system_error>
+
 namespace Afina {
-namespace Concurrency {}
+namespace Concurrency {
+
+// See Executor.h
+void perform(Executor *executor) {
+    std::unique_lock<std::mutex> lock(executor->mutex);
+    for (;;) {
+        if (executor->tasks.empty()) {
+            // Queue is drained, nothing is going to appear there anymore
+            if (executor->state != Executor::State::kRun) {
+                break;
+            }
+
+            executor->free_threads++;
+            bool timeout = executor->empty_condition.wait_for(lock, executor->idle_time) == std::cv_status::timeout;
+            executor->free_threads--;
+
+            // Extra thread has been idle long enough
+            if (timeout && executor->tasks.empty() && executor->threads > executor->low_watermark) {
+                break;
+            }
+            continue;
+        }
+
+        std::function<void()> task = std::move(executor->tasks.front());
+        executor->tasks.pop_front();
+
+        lock.unlock();
+        try {
+            task();
+        } catch (...) {
+            // Task is responsible for its own errors, thread goes on with the next one
+        }
+        lock.lock();
+    }
+
+    // Nobody touches executor after the last thread is gone, it might be destroyed right away
+    executor->threads--;
+    if (executor->threads == 0 && executor->state != Executor::State::kRun) {
+        executor->state = Executor::State::kStopped;
+        executor->stop_condition.notify_all();
+    }
+}
+
+// See Executor.h
+Executor::Executor(std::string name, size_t low_watermark, size_t high_watermark, size_t max_queue_size,
+                   std::chrono::milliseconds idle_time)
+    : name(name), low_watermark(low_watermark), high_watermark(std::max(low_watermark, high_watermark)),
+      max_queue_size(max_queue_size), idle_time(idle_time), threads(0), free_threads(0), state(State::kRun) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < low_watermark; i++) {
+        std::thread(perform, this).detach();
+        threads++;
+    }
+}
+
+// See Executor.h
+Executor::~Executor() { Stop(true); }
+
+// See Executor.h
+void Executor::Stop(bool await) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (state == State::kRun) {
+        state = threads > 0 ? State::kStopping : State::kStopped;
+        empty_condition.notify_all();
+    }
+
+    if (await) {
+        stop_condition.wait(lock, [this] { return state == State::kStopped; });
+    }
+}
+
+// See Executor.h
+bool Executor::Enqueue(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state != State::kRun || tasks.size() >= max_queue_size) {
+        return false;
+    }
+    tasks.push_back(std::move(task));
+
+    // Every queued task should have a thread to pick it up
+    if (tasks.size() > free_threads && threads < high_watermark) {
+        try {
+            std::thread(perform, this).detach();
+            threads++;
+        } catch (std::system_error &) {
+            // Out of threads, task waits for a busy one unless there is none at all
+            if (threads == 0) {
+                tasks.pop_back();
+                return false;
+            }
+        }
+    }
+
+    empty_condition.notify_one();
+    return true;
+}
+
+} // namespace Concurrency
 } // namespace Afina
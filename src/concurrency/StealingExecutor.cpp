@@ -0,0 +1,149 @@
+#include <afina/concurrency/StealingExecutor.h>
+
+#include "ChaseLevDeque.h"
+
+namespace Afina {
+namespace Concurrency {
+
+namespace {
+
+// Pool thread running on the calling thread
+thread_local void *t_worker = nullptr;
+
+} // namespace
+
+/**
+ * Pool thread along with its tasks
+ */
+struct StealingExecutor::worker {
+    worker(StealingExecutor *e, size_t i) : owner(e), id(i) {}
+
+    StealingExecutor *owner;
+    size_t id;
+    ChaseLevDeque<task> tasks;
+};
+
+// See StealingExecutor.h
+StealingExecutor::StealingExecutor(std::string name, size_t size)
+    : _name(name), _pending(0), _sleeping(0), _running(true) {
+    for (size_t i = 0; i < size; i++) {
+        _workers.emplace_back(new worker(this, i));
+    }
+    for (auto &w : _workers) {
+        _threads.emplace_back(&StealingExecutor::OnRun, this, std::ref(*w));
+    }
+}
+
+// See StealingExecutor.h
+StealingExecutor::~StealingExecutor() { Stop(true); }
+
+// See StealingExecutor.h
+void StealingExecutor::Stop(bool await) {
+    {
+        std::lock_guard<std::mutex> lock(_idle_mutex);
+        _running = false;
+        _idle.notify_all();
+    }
+
+    if (await) {
+        for (std::thread &t : _threads) {
+            t.join();
+        }
+        _threads.clear();
+    }
+}
+
+// See StealingExecutor.h
+bool StealingExecutor::Enqueue(task func) {
+    // Counted before checking the state, so that threads don't finish while task is being added, and
+    // before task becomes visible, so that sleeping thread can't miss it
+    _pending++;
+    if (!_running) {
+        _pending--;
+        return false;
+    }
+
+    task *t = new task(std::move(func));
+
+    worker *w = static_cast<worker *>(t_worker);
+    if (w != nullptr && w->owner == this) {
+        w->tasks.Push(t);
+    } else {
+        std::lock_guard<std::mutex> lock(_inject_mutex);
+        _inject.push_back(t);
+    }
+
+    if (_sleeping > 0) {
+        std::lock_guard<std::mutex> lock(_idle_mutex);
+        _idle.notify_one();
+    }
+    return true;
+}
+
+// See StealingExecutor.h
+void StealingExecutor::OnRun(worker &w) {
+    t_worker = &w;
+    for (;;) {
+        task *t = nullptr;
+        for (int i = 0; i < kStealAttempts && t == nullptr; i++) {
+            t = Find(w);
+            if (t == nullptr && _pending == 0) {
+                break;
+            }
+        }
+
+        if (t != nullptr) {
+            _pending--;
+            try {
+                (*t)();
+            } catch (...) {
+                // Task is responsible for its own errors, thread goes on with the next one
+            }
+            delete t;
+            continue;
+        }
+
+        // Queued tasks are completed before threads finish
+        std::unique_lock<std::mutex> lock(_idle_mutex);
+        if (!_running && _pending == 0) {
+            break;
+        }
+
+        // Enqueue increments _pending before checking _sleeping and here it goes in the opposite
+        // order, so at least one of them sees the other
+        _sleeping++;
+        if (_pending == 0 && _running) {
+            _idle.wait(lock);
+        }
+        _sleeping--;
+    }
+    t_worker = nullptr;
+}
+
+// See StealingExecutor.h
+StealingExecutor::task *StealingExecutor::Find(worker &w) {
+    task *t = w.tasks.Take();
+    if (t != nullptr) {
+        return t;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_inject_mutex);
+        if (!_inject.empty()) {
+            t = _inject.front();
+            _inject.pop_front();
+            return t;
+        }
+    }
+
+    for (size_t i = 1; i < _workers.size(); i++) {
+        t = _workers[(w.id + i) % _workers.size()]->tasks.Steal();
+        if (t != nullptr) {
+            return t;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace Concurrency
+} // namespace Afina
@@ -0,0 +1,118 @@
+#include "Context.h"
+
+#include <cstdint>
+
+#if !defined(__x86_64__)
+#include <ucontext.h>
+#endif
+
+#if defined(__x86_64__)
+// Saves callee-saved registers on the current stack, stores stack pointer to *from_sp and restores
+// registers from to_sp. That is all the state compiler expects to survive a function call
+extern "C" void afina_coroutine_switch(void **from_sp, void *to_sp);
+
+// New stack "returns" here: calls function from r13 passing r12 to it
+extern "C" void afina_coroutine_start();
+
+asm(R"(
+    .text
+    .globl afina_coroutine_switch
+    .hidden afina_coroutine_switch
+    .type afina_coroutine_switch, @function
+afina_coroutine_switch:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size afina_coroutine_switch, .-afina_coroutine_switch
+
+    .globl afina_coroutine_start
+    .hidden afina_coroutine_start
+    .type afina_coroutine_start, @function
+afina_coroutine_start:
+    movq %r12, %rdi
+    callq *%r13
+    ud2
+    .size afina_coroutine_start, .-afina_coroutine_start
+)");
+#endif
+
+namespace Afina {
+namespace Coroutine {
+
+#if defined(__x86_64__)
+// See Context.h
+void InitStack(void *&sp, char *low, char *high, void (*entry)(void *), void *arg) {
+    // Stack looks as if routine called afina_coroutine_switch right before afina_coroutine_start
+    void **top = reinterpret_cast<void **>(reinterpret_cast<uintptr_t>(high) & ~uintptr_t(15));
+    *--top = nullptr;
+    *--top = nullptr;
+    *--top = reinterpret_cast<void *>(&afina_coroutine_start);
+    *--top = nullptr;                         // rbp
+    *--top = nullptr;                         // rbx
+    *--top = arg;                             // r12
+    *--top = reinterpret_cast<void *>(entry); // r13
+    *--top = nullptr;                         // r14
+    *--top = nullptr;                         // r15
+    sp = top;
+}
+
+// See Context.h
+void SwitchStack(void *&from, void *to) { afina_coroutine_switch(&from, to); }
+
+// See Context.h
+void FreeStack(void *&sp) { sp = nullptr; }
+#else
+namespace {
+
+// Portable but slower: swapcontext saves signal mask by syscall
+void UcontextStart(int entry_hi, int entry_lo, int arg_hi, int arg_lo) {
+    uintptr_t entry = (uintptr_t(unsigned(entry_hi)) << 32) | uintptr_t(unsigned(entry_lo));
+    uintptr_t arg = (uintptr_t(unsigned(arg_hi)) << 32) | uintptr_t(unsigned(arg_lo));
+    reinterpret_cast<void (*)(void *)>(entry)(reinterpret_cast<void *>(arg));
+}
+
+} // namespace
+
+// See Context.h
+void InitStack(void *&sp, char *low, char *high, void (*entry)(void *), void *arg) {
+    ucontext_t *uc = new ucontext_t();
+    getcontext(uc);
+    uc->uc_stack.ss_sp = low;
+    uc->uc_stack.ss_size = high - low;
+    uc->uc_link = nullptr;
+
+    uint64_t e = reinterpret_cast<uintptr_t>(entry);
+    uint64_t a = reinterpret_cast<uintptr_t>(arg);
+    makecontext(uc, reinterpret_cast<void (*)()>(&UcontextStart), 4, int(e >> 32), int(e), int(a >> 32), int(a));
+    sp = uc;
+}
+
+// See Context.h
+void SwitchStack(void *&from, void *to) {
+    if (from == nullptr) {
+        from = new ucontext_t();
+    }
+    swapcontext(static_cast<ucontext_t *>(from), static_cast<ucontext_t *>(to));
+}
+
+// See Context.h
+void FreeStack(void *&sp) {
+    delete static_cast<ucontext_t *>(sp);
+    sp = nullptr;
+}
+#endif
+
+} // namespace Coroutine
+} // namespace Afina
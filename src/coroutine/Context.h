@@ -0,0 +1,27 @@
+#ifndef AFINA_COROUTINE_CONTEXT_H
+#define AFINA_COROUTINE_CONTEXT_H
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * Prepares stack between low and high so that the first switch to sp calls entry(arg) on it. Entry
+ * must never return, it has to switch away instead
+ */
+void InitStack(void *&sp, char *low, char *high, void (*entry)(void *), void *arg);
+
+/**
+ * Saves registers of the caller to from and resumes context saved in to. Returns once somebody
+ * switches back to from
+ */
+void SwitchStack(void *&from, void *to);
+
+/**
+ * Releases resources of the context saved in sp, stack itself belongs to the caller
+ */
+void FreeStack(void *&sp);
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_CONTEXT_H
@@ -1,19 +1,216 @@
 #include <afina/coroutine/Engine.h>
 
+#include <new>
+
 #include <setjmp.h>
 #include <stdio.h>
 #include <string.h>
 
+#include "Context.h"
+#include "StackPool.h"
+
 namespace Afina {
 namespace Coroutine {
 
-void Engine::Store(context &ctx) {}
+// See Engine.h
+Engine::Engine(unblocker_func unblocker, size_t stack_size)
+    : StackBottom(0), cur_routine(nullptr), alive(nullptr), blocked(nullptr), idle_ctx(nullptr),
+      _unblocker(unblocker), _stacks(stack_size > 0 ? new StackPool(stack_size) : nullptr), zombie_ctx(nullptr) {}
+
+// See Engine.h
+Engine::~Engine() {}
+
+// See Engine.h
+void Engine::Store(context &ctx) {
+    // Stack grows down, so everything from here up to the bottom belongs to the routine
+    char StackEndsHere;
+    ctx.Low = &StackEndsHere;
+    ctx.Hight = StackBottom;
+
+    uint32_t size = ctx.Hight - ctx.Low;
+    char *&buffer = std::get<0>(ctx.Stack);
+    uint32_t &capacity = std::get<1>(ctx.Stack);
+    if (capacity < size) {
+        delete[] buffer;
+        buffer = new char[size];
+        capacity = size;
+    }
+    memcpy(buffer, ctx.Low, size);
+}
+
+// See Engine.h
+void Engine::Restore(context &ctx) {
+    // Copying stack back would overwrite this very frame unless it is below the saved one, so go
+    // deeper first. Padding is touched after the call to keep compiler from reusing the frame
+    volatile char StackEndsHere[256];
+    if (StackEndsHere + sizeof(StackEndsHere) >= ctx.Low) {
+        StackEndsHere[0] = 0;
+        Restore(ctx);
+        StackEndsHere[0]++;
+    }
+
+    memcpy(ctx.Low, std::get<0>(ctx.Stack), ctx.Hight - ctx.Low);
+    longjmp(ctx.Environment, 1);
+}
+
+// See Engine.h
+void Engine::yield() {
+    // Round robin over alive routines, starting after the current one
+    context *next = nullptr;
+    if (cur_routine != nullptr && !cur_routine->Blocked) {
+        next = cur_routine->next;
+    }
+    if (next == nullptr) {
+        next = alive;
+    }
+    if (next != nullptr && next != cur_routine) {
+        sched(next);
+        return;
+    }
+
+    // Nobody else could run. Running routine just goes on, but the blocked one has to give
+    // control back to the engine, so that unblocker could wake up someone
+    if (cur_routine == nullptr || !cur_routine->Blocked) {
+        return;
+    }
+
+    Transfer(nullptr);
+}
+
+// See Engine.h
+void Engine::sched(void *routine_) {
+    context *routine = static_cast<context *>(routine_);
+    if (routine == nullptr) {
+        yield();
+        return;
+    }
+    if (routine == cur_routine || routine->Blocked) {
+        return;
+    }
+
+    Transfer(routine);
+}
+
+// See Engine.h
+void Engine::block(void *coro) {
+    context *routine = coro == nullptr ? cur_routine : static_cast<context *>(coro);
+    if (routine == nullptr || routine->Blocked) {
+        return;
+    }
+
+    Unlink(alive, *routine);
+    Link(blocked, *routine);
+    routine->Blocked = true;
+
+    if (routine == cur_routine) {
+        yield();
+    }
+}
+
+// See Engine.h
+void Engine::unblock(void *coro) {
+    context *routine = static_cast<context *>(coro);
+    if (routine == nullptr || !routine->Blocked) {
+        return;
+    }
+
+    Unlink(blocked, *routine);
+    Link(alive, *routine);
+    routine->Blocked = false;
+}
+
+// See Engine.h
+void Engine::Transfer(context *to) {
+    context *from = cur_routine;
+    cur_routine = to;
+
+    if (_stacks) {
+        SwitchStack(from != nullptr ? from->SP : idle_ctx->SP, to != nullptr ? to->SP : idle_ctx->SP);
+        return;
+    }
+
+    // Engine itself has no routine to save, it always continues from the start
+    if (from != nullptr) {
+        if (setjmp(from->Environment) > 0) {
+            return;
+        }
+        Store(*from);
+    }
+    Restore(to != nullptr ? *to : *idle_ctx);
+}
+
+// See Engine.h
+bool Engine::Prepare(context &ctx) {
+    try {
+        ctx.Low = _stacks->Get();
+    } catch (std::bad_alloc &) {
+        return false;
+    }
+
+    ctx.Hight = ctx.Low + _stacks->StackSize();
+    InitStack(ctx.SP, ctx.Low, ctx.Hight, &Engine::Entry, this);
+    return true;
+}
+
+// See Engine.h
+void Engine::Loop() {
+    for (;;) {
+        // Routine is done and can't run on its stack anymore
+        if (zombie_ctx != nullptr) {
+            _stacks->Put(zombie_ctx->Low);
+            FreeStack(zombie_ctx->SP);
+            delete zombie_ctx;
+            zombie_ctx = nullptr;
+        }
+
+        if (alive == nullptr) {
+            _unblocker(*this);
+        }
+        if (alive == nullptr) {
+            break;
+        }
+        Transfer(alive);
+    }
+    FreeStack(idle_ctx->SP);
+}
+
+// See Engine.h
+void Engine::Entry(void *arg) {
+    Engine *engine = static_cast<Engine *>(arg);
+    context *ctx = engine->cur_routine;
+    ctx->Routine->call();
+
+    delete ctx->Routine;
+    ctx->Routine = nullptr;
+    Unlink(engine->alive, *ctx);
 
-void Engine::Restore(context &ctx) {}
+    // Stack is released by the engine, this one is still running on it
+    engine->zombie_ctx = ctx;
+    engine->Transfer(nullptr);
+}
 
-void Engine::yield() {}
+// See Engine.h
+void Engine::Unlink(context *&list, context &ctx) {
+    if (ctx.prev != nullptr) {
+        ctx.prev->next = ctx.next;
+    } else {
+        list = ctx.next;
+    }
+    if (ctx.next != nullptr) {
+        ctx.next->prev = ctx.prev;
+    }
+    ctx.prev = ctx.next = nullptr;
+}
 
-void Engine::sched(void *routine_) {}
+// See Engine.h
+void Engine::Link(context *&list, context &ctx) {
+    ctx.prev = nullptr;
+    ctx.next = list;
+    if (list != nullptr) {
+        list->prev = &ctx;
+    }
+    list = &ctx;
+}
 
 } // namespace Coroutine
 } // namespace Afina
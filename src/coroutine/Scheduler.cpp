@@ -0,0 +1,386 @@
+#include <afina/coroutine/Scheduler.h>
+
+#include <chrono>
+#include <new>
+#include <thread>
+
+#include "Context.h"
+#include "StackPool.h"
+
+namespace Afina {
+namespace Coroutine {
+
+namespace {
+
+// Why fiber gave control back to the worker
+enum { kYield, kBlock, kDone };
+
+// Worker running on the calling thread
+thread_local void *t_worker = nullptr;
+
+// Fiber could continue on another thread after each switch, so address of the thread local
+// variable must be computed anew every time instead of being cached by compiler across the switch
+__attribute__((noinline)) void *CurrentWorker() {
+    asm volatile("" ::: "memory");
+    return t_worker;
+}
+
+} // namespace
+
+/**
+ * Coroutine along with its stack
+ */
+struct Scheduler::fiber {
+    std::function<void()> Routine;
+
+    // Called instead of the routine if fiber never gets a stack
+    std::function<void()> OnFail;
+    int StackFailures = 0;
+
+    // Lowest address of the stack, nullptr until fiber runs first time
+    char *Low = nullptr;
+
+    // Saved stack pointer
+    void *SP = nullptr;
+
+    // Guards two fields below
+    std::mutex Lock;
+
+    // Fiber isn't in any queue and waits for unblock
+    bool Blocked = false;
+
+    // Unblock came while fiber was running, next block returns right away
+    bool Permit = false;
+};
+
+/**
+ * Thread running fibers
+ */
+struct Scheduler::worker {
+    worker(Scheduler *s, size_t i, size_t stack_size) : owner(s), id(i), stacks(new StackPool(stack_size)) {}
+
+    Scheduler *owner;
+    size_t id;
+
+    // Ready fibers: owner takes them from the front, thieves from the back
+    std::mutex mutex;
+    std::deque<fiber *> queue;
+
+    // Accessed by the owner thread only
+    std::unique_ptr<StackPool> stacks;
+    void *SP = nullptr;
+    fiber *current = nullptr;
+    int reason = kYield;
+};
+
+const int Scheduler::kPollTimeout;
+const int Scheduler::kStackAttempts;
+const int Scheduler::kStackBackoff;
+
+// See Scheduler.h
+Scheduler::Scheduler(poller_func poller, size_t stack_size)
+    : _poller(poller), _stack_size(stack_size), _ready(0), _live(0), _polling(false), _sleeping(0),
+      _stopping(false) {}
+
+// See Scheduler.h
+Scheduler::~Scheduler() {
+    Join();
+
+    // Fibers that were never started
+    for (fiber *f : _inject) {
+        delete f;
+    }
+    for (auto &w : _workers) {
+        for (fiber *f : w->queue) {
+            delete f;
+        }
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Start(size_t threads) {
+    _stopping = false;
+    for (size_t i = 0; i < threads; i++) {
+        _workers.emplace_back(new worker(this, i, _stack_size));
+    }
+    for (auto &w : _workers) {
+        _threads.emplace_back(&Scheduler::OnRun, this, std::ref(*w));
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Stop() {
+    _stopping = true;
+
+    std::lock_guard<std::mutex> lock(_idle_mutex);
+    _idle.notify_all();
+}
+
+// See Scheduler.h
+void Scheduler::Join() {
+    for (std::thread &t : _threads) {
+        t.join();
+    }
+    _threads.clear();
+}
+
+// See Scheduler.h
+void *Scheduler::run(std::function<void()> func, std::function<void()> on_fail) {
+    fiber *f = new fiber();
+    f->Routine = std::move(func);
+    f->OnFail = std::move(on_fail);
+
+    _live++;
+    Push(f);
+    return f;
+}
+
+// See Scheduler.h
+void Scheduler::yield() {
+    if (current() != nullptr) {
+        Leave(kYield);
+    }
+}
+
+// See Scheduler.h
+void Scheduler::block() {
+    fiber *f = static_cast<fiber *>(current());
+    if (f == nullptr) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(f->Lock);
+        if (f->Permit) {
+            f->Permit = false;
+            return;
+        }
+    }
+
+    // Worker decides whether fiber is blocked once it is off the stack, unblock could come in between
+    Leave(kBlock);
+}
+
+// See Scheduler.h
+void Scheduler::unblock(void *coro) {
+    fiber *f = static_cast<fiber *>(coro);
+    if (f == nullptr) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(f->Lock);
+        if (!f->Blocked) {
+            f->Permit = true;
+            return;
+        }
+        f->Blocked = false;
+    }
+    Push(f);
+}
+
+// See Scheduler.h
+void *Scheduler::current() {
+    worker *w = static_cast<worker *>(CurrentWorker());
+    return w != nullptr ? w->current : nullptr;
+}
+
+// See Scheduler.h
+void Scheduler::OnRun(worker &w) {
+    t_worker = &w;
+    for (;;) {
+        fiber *f = Pop(w);
+        if (f != nullptr) {
+            Execute(w, f);
+            continue;
+        }
+
+        if (_stopping && _live == 0) {
+            break;
+        }
+
+        // Only one worker waits for events at a time, so every event wakes up a single fiber
+        if (_poller && !_polling.exchange(true)) {
+            _poller(*this, kPollTimeout);
+            _polling = false;
+            continue;
+        }
+
+        // Pusher increments _ready before checking _sleeping and here it goes in the opposite
+        // order, so at least one of them sees the other. Timeout lets sleeper to take over polling
+        std::unique_lock<std::mutex> lock(_idle_mutex);
+        _sleeping++;
+        if (_ready == 0 && !(_stopping && _live == 0)) {
+            _idle.wait_for(lock, std::chrono::milliseconds(kPollTimeout));
+        }
+        _sleeping--;
+    }
+    t_worker = nullptr;
+}
+
+// See Scheduler.h
+void Scheduler::Execute(worker &w, fiber *f) {
+    if (f->SP == nullptr) {
+        try {
+            f->Low = w.stacks->Get();
+        } catch (std::bad_alloc &) {
+            // No memory for the stack right now, give it a few more chances after a pause instead of
+            // spinning on mmap, then give up on the fiber
+            if (++f->StackFailures < kStackAttempts) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(kStackBackoff));
+                Push(f);
+                return;
+            }
+
+            if (f->OnFail) {
+                f->OnFail();
+            }
+            Retire(f);
+            return;
+        }
+        InitStack(f->SP, f->Low, f->Low + w.stacks->StackSize(), &Scheduler::Entry, this);
+    }
+
+    w.current = f;
+    SwitchStack(w.SP, f->SP);
+    w.current = nullptr;
+
+    // Fiber is off its stack now, so it is safe to hand it over to other threads
+    switch (w.reason) {
+    case kYield:
+        Push(f);
+        break;
+
+    case kBlock: {
+        std::unique_lock<std::mutex> lock(f->Lock);
+        if (f->Permit) {
+            f->Permit = false;
+            lock.unlock();
+            Push(f);
+        } else {
+            f->Blocked = true;
+        }
+        break;
+    }
+
+    case kDone:
+        // Stacks are of the same size everywhere, so it goes to the pool of this worker
+        w.stacks->Put(f->Low);
+        FreeStack(f->SP);
+        Retire(f);
+        break;
+    }
+}
+
+void Scheduler::Retire(fiber *f) {
+    delete f;
+    if (--_live == 0 && _stopping) {
+        std::lock_guard<std::mutex> lock(_idle_mutex);
+        _idle.notify_all();
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Push(fiber *f) {
+    // Counted before fiber becomes visible, so _ready never drops below real number
+    _ready++;
+
+    worker *w = static_cast<worker *>(CurrentWorker());
+    if (w != nullptr && w->owner == this) {
+        std::lock_guard<std::mutex> lock(w->mutex);
+        w->queue.push_back(f);
+    } else {
+        std::lock_guard<std::mutex> lock(_inject_mutex);
+        _inject.push_back(f);
+    }
+    Notify();
+}
+
+// See Scheduler.h
+Scheduler::fiber *Scheduler::Pop(worker &w) {
+    {
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (!w.queue.empty()) {
+            fiber *f = w.queue.front();
+            w.queue.pop_front();
+            _ready--;
+            return f;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_inject_mutex);
+        if (!_inject.empty()) {
+            fiber *f = _inject.front();
+            _inject.pop_front();
+            _ready--;
+            return f;
+        }
+    }
+
+    return Steal(w);
+}
+
+// See Scheduler.h
+Scheduler::fiber *Scheduler::Steal(worker &w) {
+    if (_ready == 0) {
+        return nullptr;
+    }
+
+    std::vector<fiber *> taken;
+    for (size_t i = 1; i < _workers.size() && taken.empty(); i++) {
+        worker &victim = *_workers[(w.id + i) % _workers.size()];
+
+        // Half of the queue from the back, victim keeps the fibers it is going to run soon
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        size_t count = (victim.queue.size() + 1) / 2;
+        for (size_t j = 0; j < count; j++) {
+            taken.push_back(victim.queue.back());
+            victim.queue.pop_back();
+        }
+    }
+    if (taken.empty()) {
+        return nullptr;
+    }
+
+    // Oldest one runs right now, the rest keep their order in the own queue
+    fiber *result = taken.back();
+    taken.pop_back();
+    _ready--;
+    if (!taken.empty()) {
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.queue.insert(w.queue.end(), taken.rbegin(), taken.rend());
+    }
+    return result;
+}
+
+// See Scheduler.h
+void Scheduler::Leave(int reason) {
+    // Nothing from the current thread could be used after switch, fiber might wake up on another one
+    worker *w = static_cast<worker *>(CurrentWorker());
+    fiber *f = w->current;
+    w->reason = reason;
+    SwitchStack(f->SP, w->SP);
+}
+
+// See Scheduler.h
+void Scheduler::Notify() {
+    if (_sleeping > 0) {
+        std::lock_guard<std::mutex> lock(_idle_mutex);
+        _idle.notify_one();
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Entry(void *scheduler) {
+    Scheduler *s = static_cast<Scheduler *>(scheduler);
+    fiber *f = static_cast<fiber *>(current());
+    f->Routine();
+
+    // Captured objects are destroyed while stack is still alive
+    f->Routine = nullptr;
+    s->Leave(kDone);
+}
+
+} // namespace Coroutine
+} // namespace Afina
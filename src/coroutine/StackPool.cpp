@@ -0,0 +1,58 @@
+#include "StackPool.h"
+
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Coroutine {
+
+// See StackPool.h
+StackPool::StackPool(size_t stack_size, size_t max_free)
+    : _page_size(sysconf(_SC_PAGESIZE)), _max_free(max_free) {
+    _stack_size = (stack_size + _page_size - 1) & ~(_page_size - 1);
+}
+
+// See StackPool.h
+StackPool::~StackPool() {
+    for (char *stack : _free) {
+        Unmap(stack);
+    }
+}
+
+// See StackPool.h
+char *StackPool::Get() {
+    if (!_free.empty()) {
+        char *result = _free.back();
+        _free.pop_back();
+        return result;
+    }
+
+    // Pages are not committed until touched, so only the part stack really uses costs memory
+    void *mem = mmap(nullptr, _page_size + _stack_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK,
+                     -1, 0);
+    if (mem == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    if (mprotect(mem, _page_size, PROT_NONE) != 0) {
+        munmap(mem, _page_size + _stack_size);
+        throw std::bad_alloc();
+    }
+    return static_cast<char *>(mem) + _page_size;
+}
+
+// See StackPool.h
+void StackPool::Put(char *stack) {
+    if (_free.size() < _max_free) {
+        _free.push_back(stack);
+    } else {
+        Unmap(stack);
+    }
+}
+
+void StackPool::Unmap(char *stack) { munmap(stack - _page_size, _page_size + _stack_size); }
+
+} // namespace Coroutine
+} // namespace Afina
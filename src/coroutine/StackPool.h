@@ -0,0 +1,55 @@
+#ifndef AFINA_COROUTINE_STACK_POOL_H
+#define AFINA_COROUTINE_STACK_POOL_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # Stacks for coroutines
+ * Every stack is a separate mapping with a guard page below it, so overflow crashes right away
+ * instead of corrupting memory around. Stacks of finished coroutines are kept for reuse, mapping
+ * and protecting pages costs several syscalls.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class StackPool {
+public:
+    /**
+     * @param stack_size usable size of each stack, rounded up to pages
+     * @param max_free how many free stacks to keep, the rest is unmapped
+     */
+    StackPool(size_t stack_size, size_t max_free = 64);
+    ~StackPool();
+
+    size_t StackSize() const { return _stack_size; }
+
+    /**
+     * Returns the lowest address of the usable stack area, throws std::bad_alloc if system
+     * can't map more
+     */
+    char *Get();
+
+    /**
+     * Returns stack taken by Get back to the pool
+     */
+    void Put(char *stack);
+
+private:
+    StackPool(const StackPool &) = delete;
+    StackPool &operator=(const StackPool &) = delete;
+
+    void Unmap(char *stack);
+
+    size_t _page_size;
+    size_t _stack_size;
+    size_t _max_free;
+    std::vector<char *> _free;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_STACK_POOL_H
@@ -1,3 +1,4 @@
+#include <afina/Counters.h>
 #include <afina/Storage.h>
 #include <afina/execute/Add.h>
 
@@ -10,7 +11,8 @@ namespace Execute {
 // hold data for this key".
 void Add::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Add(" << _key << ")" << args << std::endl;
-    out = storage.PutIfAbsent(_key, args) ? "STORED" : "NOT_STORED";
+    LocalCounters().cmd_set.Add();
+    out = storage.PutIfAbsent(_key, args, ExpireAt()) ? "STORED" : "NOT_STORED";
 }
 
 } // namespace Execute
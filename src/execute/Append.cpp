@@ -1,3 +1,4 @@
+#include <afina/Counters.h>
 #include <afina/Storage.h>
 #include <afina/execute/Append.h>
 
@@ -9,12 +10,16 @@ namespace Execute {
 // memcached protocol: "append" means "add this data to an existing key after existing data".
 void Append::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Append(" << _key << ")" << args << std::endl;
+    LocalCounters().cmd_set.Add();
+
+    // Expiration time given with the command is ignored, item keeps its own one as in memcached
     std::string value;
-    if (!storage.Get(_key, value)) {
+    std::time_t expire_at;
+    if (!storage.Get(_key, value, expire_at)) {
         out.assign("NOT_STORED");
         return;
     }
-    storage.Put(_key, value + args);
+    storage.Put(_key, value + args, expire_at);
     out.assign("STORED");
 }
 
@@ -1 +1,15 @@
 #include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Command.h
+void Command::Execute(Storage &storage, const std::string &args, Response &out) {
+    std::string result;
+    Execute(storage, args, result);
+    out.Append(result);
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,14 @@
+#include <afina/Storage.h>
+#include <afina/execute/FlushAll.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "flush_all" invalidates all existing items
+void FlushAll::Execute(Storage &storage, const std::string &args, std::string &out) {
+    storage.FlushAll();
+    out.assign("OK");
+}
+
+} // namespace Execute
+} // namespace Afina
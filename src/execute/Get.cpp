@@ -1,8 +1,10 @@
+#include <afina/Counters.h>
 #include <afina/Storage.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Response.h>
 
+#include <cstdio>
 #include <iostream>
-#include <iterator>
 #include <sstream>
 
 namespace Afina {
@@ -21,18 +23,38 @@ to indicate the end of response.
 
 */
 
+// See Get.h
+std::vector<std::string> Get::keys() const {
+    std::vector<std::string> result;
+    result.reserve(_keys.Size());
+    for (size_t i = 0; i < _keys.Size(); i++) {
+        result.push_back(_keys[i].str());
+    }
+    return result;
+}
+
 void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::stringstream keyStream;
-    copy(_keys.begin(), _keys.end(), std::ostream_iterator<std::string>(keyStream, " "));
+    for (size_t i = 0; i < _keys.Size(); i++) {
+        keyStream << _keys[i].str() << " ";
+    }
     std::cout << "Get(" << keyStream.str() << ")" << std::endl;
 
+    Counters &counters = LocalCounters();
+    counters.cmd_get.Add(_keys.Size());
+
     std::stringstream outStream;
 
     std::string value;
-    for (auto &key : _keys) {
-        if (!storage.Get(key, value))
+    for (size_t i = 0; i < _keys.Size(); i++) {
+        KeyView key = _keys[i];
+        _key.assign(key.data, key.size);
+        if (!storage.Get(_key, value)) {
+            counters.get_misses.Add();
             continue;
-        outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
+        }
+        counters.get_hits.Add();
+        outStream << "VALUE " << _key << " 0 " << value.size() << "\r\n";
         outStream << value << "\r\n";
     }
     outStream << "END"; // networking layer should add the last \r\n
@@ -40,5 +62,31 @@ void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
     out = outStream.str();
 }
 
+// Header is written piece by piece right into the response, so there are no temporary strings
+void Get::Execute(Storage &storage, const std::string &args, Response &out) {
+    Counters &counters = LocalCounters();
+    counters.cmd_get.Add(_keys.Size());
+
+    ValueView value;
+    for (size_t i = 0; i < _keys.Size(); i++) {
+        KeyView key = _keys[i];
+        _key.assign(key.data, key.size);
+        if (!storage.Pin(_key, value)) {
+            counters.get_misses.Add();
+            continue;
+        }
+        counters.get_hits.Add();
+
+        char size[32];
+        int size_length = std::snprintf(size, sizeof(size), " 0 %zu\r\n", value.size());
+        out.Append("VALUE ", 6);
+        out.Append(key.data, key.size);
+        out.Append(size, size_length);
+        out.Append(std::move(value));
+        out.Append("\r\n", 2);
+    }
+    out.Append("END", 3); // networking layer should add the last \r\n
+}
+
 } // namespace Execute
 } // namespace Afina
@@ -1,3 +1,4 @@
+#include <afina/Counters.h>
 #include <afina/Storage.h>
 #include <afina/execute/Replace.h>
 
@@ -11,9 +12,11 @@ namespace Execute {
 
 void Replace::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Replace(" << _key << "): " << args << std::endl;
+    LocalCounters().cmd_set.Add();
+
     std::string value;
     if (storage.Get(_key, value)) {
-        storage.Set(_key, args);
+        storage.Set(_key, args, ExpireAt());
         out = "STORED";
     } else {
         out = "NOT_STORED";
@@ -0,0 +1,72 @@
+#include <afina/execute/Response.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Response.h
+void Response::Append(const char *text, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    // Glue adjacent text chunks together
+    if (!_chunks.empty() && _chunks.back().value.data() == nullptr) {
+        _chunks.back().text_size += size;
+    } else {
+        _chunks.push_back(chunk{_text.size(), size, ValueView()});
+    }
+    _text.append(text, size);
+}
+
+// See Response.h
+void Response::Append(ValueView &&value) {
+    // Empty value is never sent, but caller expects the view to be taken anyway
+    if (value.size() == 0) {
+        value.Reset();
+        return;
+    }
+    _chunks.push_back(chunk{0, 0, std::move(value)});
+}
+
+// See Response.h
+size_t Response::Fill(struct iovec *iov, size_t iov_size) const {
+    size_t filled = 0;
+    size_t skip = _sent;
+    for (auto it = _chunks.begin(); it != _chunks.end() && filled < iov_size; it++) {
+        const char *data = it->value.data() != nullptr ? it->value.data() : &_text[it->text_begin];
+        iov[filled].iov_base = const_cast<char *>(data + skip);
+        iov[filled].iov_len = it->size() - skip;
+        filled++;
+        skip = 0;
+    }
+    return filled;
+}
+
+// See Response.h
+void Response::Consume(size_t size) {
+    while (size > 0 && !_chunks.empty()) {
+        size_t left = _chunks.front().size() - _sent;
+        if (size < left) {
+            _sent += size;
+            return;
+        }
+
+        size -= left;
+        _sent = 0;
+        _chunks.pop_front();
+    }
+
+    if (_chunks.empty()) {
+        _text.clear();
+    }
+}
+
+// See Response.h
+void Response::Clear() {
+    _chunks.clear();
+    _text.clear();
+    _sent = 0;
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1,3 +1,4 @@
+#include <afina/Counters.h>
 #include <afina/Storage.h>
 #include <afina/execute/Set.h>
 
@@ -9,7 +10,8 @@ namespace Execute {
 // memcached protocol: "set" means "store this data".
 void Set::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Set(" << _key << "): " << args << std::endl;
-    storage.Put(_key, args);
+    LocalCounters().cmd_set.Add();
+    storage.Put(_key, args, ExpireAt());
     out = "STORED";
 }
 
@@ -1,14 +1,63 @@
+#include <afina/Counters.h>
 #include <afina/Storage.h>
 #include <afina/execute/Stats.h>
 
-#include <iostream>
-#include <iterator>
+#include <ctime>
 #include <sstream>
 
+#include <unistd.h>
+
 namespace Afina {
 namespace Execute {
 
-void Stats::Execute(Storage &storage, const std::string &args, std::string &out) { out.assign("END"); }
+/* memcached protocol:
+
+Each statistic item sent by the server looks like this:
+
+STAT <name> <value>\r\n
+
+The server terminates this list with the line
+"END\r\n"
+
+*/
+
+// Counters of every thread are summed up right here, so that the threads updating them never
+// synchronize with each other. Threads keep going meanwhile, so the numbers aren't a consistent
+// snapshot, each of them is exact up to the values of concurrent commands though
+void Stats::Execute(Storage &storage, const std::string &args, std::string &out) {
+    uint64_t cmd_get = 0, get_hits = 0, get_misses = 0, cmd_set = 0;
+    uint64_t bytes_read = 0, bytes_written = 0, total_connections = 0, closed_connections = 0, evictions = 0;
+    AllCounters().ForEach([&](const Counters &c) {
+        cmd_get += c.cmd_get.Load();
+        get_hits += c.get_hits.Load();
+        get_misses += c.get_misses.Load();
+        cmd_set += c.cmd_set.Load();
+        bytes_read += c.bytes_read.Load();
+        bytes_written += c.bytes_written.Load();
+        total_connections += c.total_connections.Load();
+        closed_connections += c.closed_connections.Load();
+        evictions += c.evictions.Load();
+    });
+
+    // Connection closed on one thread could be seen before it is accepted on another one
+    uint64_t curr_connections = total_connections > closed_connections ? total_connections - closed_connections : 0;
+
+    std::stringstream outStream;
+    outStream << "STAT pid " << getpid() << "\r\n";
+    outStream << "STAT time " << std::time(nullptr) << "\r\n";
+    outStream << "STAT curr_connections " << curr_connections << "\r\n";
+    outStream << "STAT total_connections " << total_connections << "\r\n";
+    outStream << "STAT cmd_get " << cmd_get << "\r\n";
+    outStream << "STAT cmd_set " << cmd_set << "\r\n";
+    outStream << "STAT get_hits " << get_hits << "\r\n";
+    outStream << "STAT get_misses " << get_misses << "\r\n";
+    outStream << "STAT bytes_read " << bytes_read << "\r\n";
+    outStream << "STAT bytes_written " << bytes_written << "\r\n";
+    outStream << "STAT evictions " << evictions << "\r\n";
+    outStream << "END"; // networking layer should add the last \r\n
+
+    out = outStream.str();
+}
 
 } // namespace Execute
 } // namespace Afina
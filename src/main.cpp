@@ -16,13 +16,21 @@
 
 #include "logging/ServiceImpl.h"
 #include "network/mt_blocking/ServerImpl.h"
+#include "network/mt_coroutine/ServerImpl.h"
 #include "network/mt_nonblocking/ServerImpl.h"
 #include "network/st_blocking/ServerImpl.h"
 #include "network/st_coroutine/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
+#include "network/uring/ServerImpl.h"
 
+#include "storage/AllocLRU.h"
+#include "storage/ClockLRU.h"
+#include "storage/FlatCombineLRU.h"
 #include "storage/SimpleLRU.h"
+#include "storage/StripedLRU.h"
 #include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/ThreadSafeTinyLFU.h"
+#include "storage/TinyLFU.h"
 
 using namespace Afina;
 
@@ -55,6 +63,20 @@ public:
             storage = std::make_shared<Afina::Backend::SimpleLRU>();
         } else if (storage_type == "mt_lru") {
             storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+        } else if (storage_type == "fc_lru") {
+            storage = std::make_shared<Afina::Backend::FlatCombineLRU>();
+        } else if (storage_type == "striped_lru") {
+            storage = std::make_shared<Afina::Backend::StripedLRU>();
+        } else if (storage_type == "clock_lru") {
+            storage = std::make_shared<Afina::Backend::ClockLRU>();
+        } else if (storage_type == "core_clock_lru") {
+            storage = std::make_shared<Afina::Backend::ClockLRU>(1024, true);
+        } else if (storage_type == "alloc_lru") {
+            storage = std::make_shared<Afina::Backend::AllocLRU>();
+        } else if (storage_type == "st_tinylfu") {
+            storage = std::make_shared<Afina::Backend::TinyLFU>();
+        } else if (storage_type == "mt_tinylfu") {
+            storage = std::make_shared<Afina::Backend::ThreadSafeTinyLFU>();
         } else {
             throw std::runtime_error("Unknown storage type");
         }
@@ -73,8 +95,18 @@ public:
             server = std::make_shared<Afina::Network::STnonblock::ServerImpl>(storage, logService);
         } else if (network_type == "mt_nonblock") {
             server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService);
+        } else if (network_type == "mt_reuseport") {
+            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(
+                storage, logService, Afina::Network::MTnonblock::ServerImpl::Mode::ReusePort);
+        } else if (network_type == "mt_balanced") {
+            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(
+                storage, logService, Afina::Network::MTnonblock::ServerImpl::Mode::Balanced);
         } else if (network_type == "st_coroutine") {
             server = std::make_shared<Afina::Network::STcoroutine::ServerImpl>(storage, logService);
+        } else if (network_type == "mt_coroutine") {
+            server = std::make_shared<Afina::Network::MTcoroutine::ServerImpl>(storage, logService);
+        } else if (network_type == "uring") {
+            server = std::make_shared<Afina::Network::Uring::ServerImpl>(storage, logService);
         } else {
             throw std::runtime_error("Unknown network type");
         }
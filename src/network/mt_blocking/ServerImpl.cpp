@@ -13,12 +13,15 @@
 #include <signal.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <spdlog/logger.h>
 
+#include <afina/Counters.h>
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
 #include <afina/logging/Service.h>
 
 #include "protocol/Parser.h"
@@ -27,6 +30,8 @@ namespace Afina {
 namespace Network {
 namespace MTblocking {
 
+const int ServerImpl::kIdleTime;
+
 // See Server.h
 ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
 
@@ -72,6 +77,10 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
         throw std::runtime_error("Socket listen() failed");
     }
 
+    // Threads are started beforehand, so that first connections don't wait for them
+    _executor.reset(new Afina::Concurrency::Executor("mt_blocking", n_workers, kMaxWorkers, kMaxQueue,
+                                                     std::chrono::milliseconds(kIdleTime)));
+
     running.store(true);
     _thread = std::thread(&ServerImpl::OnRun, this);
 }
@@ -94,24 +103,29 @@ void ServerImpl::Join() {
     assert(_thread.joinable());
     _thread.join();
     close(_server_socket);
+
+    _executor->Stop(true);
+    _executor.reset();
 }
 
 void ServerImpl::ProcessClient(int client_socket) {
     // Here is connection state
     // - parser: parse state of the stream
-    // - command_to_execute: last command parsed out of stream
+    // - command_to_execute: last command parsed out of stream, owned by the parser
     // - arg_remains: how many bytes to read from stream to get command argument
     // - argument_for_command: buffer stores argument
     std::size_t arg_remains;
     Protocol::Parser parser;
     std::string argument_for_command;
-    std::unique_ptr<Execute::Command> command_to_execute;
+    Execute::Command *command_to_execute = nullptr;
+    LocalCounters().total_connections.Add();
 
     try {
         int readed_bytes = -1;
         char client_buffer[4096];
         while ((readed_bytes = read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
             _logger->debug("Got {} bytes from socket", readed_bytes);
+            LocalCounters().bytes_read.Add(readed_bytes);
 
             // Single block of data readed from the socket could trigger inside actions a multiple times,
             // for example:
@@ -158,20 +172,26 @@ void ServerImpl::ProcessClient(int client_socket) {
                 if (command_to_execute && arg_remains == 0) {
                     _logger->debug("Start command execution");
 
-                    std::string result;
+                    Execute::Response result;
                     if (argument_for_command.size()) {
                         argument_for_command.resize(argument_for_command.size() - 2);
                     }
                     command_to_execute->Execute(*pStorage, argument_for_command, result);
 
-                    // Send response
-                    result += "\r\n";
-                    if (send(client_socket, result.data(), result.size(), 0) <= 0) {
-                        throw std::runtime_error("Failed to send response");
+                    // Send response, values are written right from the storage memory
+                    result.Append("\r\n");
+                    while (!result.Empty()) {
+                        struct iovec iov[64];
+                        ssize_t sent = writev(client_socket, iov, result.Fill(iov, 64));
+                        if (sent <= 0) {
+                            throw std::runtime_error("Failed to send response");
+                        }
+                        LocalCounters().bytes_written.Add(sent);
+                        result.Consume(sent);
                     }
 
                     // Prepare for the next command
-                    command_to_execute.reset();
+                    command_to_execute = nullptr;
                     argument_for_command.resize(0);
                     parser.Reset();
                 }
@@ -190,6 +210,7 @@ void ServerImpl::ProcessClient(int client_socket) {
         std::unique_lock<std::mutex> guard(m);
         clients.erase(client_socket);
         close(client_socket);
+        LocalCounters().closed_connections.Add();
         if (clients.empty() && !running) {
             wait_all_to_stop.notify_one(); 
         }
@@ -230,15 +251,15 @@ void ServerImpl::OnRun() {
             setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof tv);
         }
 
-        // TODO: Start new thread and process data from/to connection
+        // Connection waits in the queue until some thread is free, once queue is full it is dropped
         {
             std::lock_guard<std::mutex> guard(m);
-            if (clients.size() == MAX_CONNECTIONS_AMOUNT) {
+            clients.insert(client_socket);
+            if (!_executor->Execute(&ServerImpl::ProcessClient, this, client_socket)) {
+                _logger->warn("Too many connections, close descriptor {}", client_socket);
+                clients.erase(client_socket);
                 close(client_socket);
-                continue;
             }
-            clients.insert(client_socket);
-            std::thread(&ServerImpl::ProcessClient, this, client_socket).detach();
         }
     }
 
@@ -246,9 +267,7 @@ void ServerImpl::OnRun() {
     _logger->warn("Network stopped");
     {
         std::unique_lock<std::mutex> lock(m);
-        if (!clients.empty() && !running) {
-            wait_all_to_stop.wait(lock);
-        }
+        wait_all_to_stop.wait(lock, [this] { return clients.empty(); });
     }
 }
 
@@ -2,11 +2,13 @@
 #define AFINA_NETWORK_MT_BLOCKING_SERVER_H
 
 #include <atomic>
+#include <memory>
 #include <thread>
 
 #include <unordered_set>
 #include <condition_variable>
 
+#include <afina/concurrency/Executor.h>
 #include <afina/network/Server.h>
 
 namespace spdlog {
@@ -19,7 +21,8 @@ namespace MTblocking {
 
 /**
  * # Network resource manager implementation
- * Server that is spawning a separate thread for each connection
+ * Server that serves each connection by a separate thread. Threads are taken from the pool and
+ * return there once connection is closed, so bursts of reconnects don't pay for thread creation
  */
 class ServerImpl : public Server {
 public:
@@ -44,7 +47,12 @@ protected:
     void ProcessClient(int client_socket);
 
 private:
-    #define MAX_CONNECTIONS_AMOUNT 2
+    // Connections served at once, connections waiting for a free thread and how long spare thread
+    // lives without work
+    static const size_t kMaxWorkers = 64;
+    static const size_t kMaxQueue = 64;
+    static const int kIdleTime = 10000;
+
     // Logger instance
     std::shared_ptr<spdlog::logger> _logger;
 
@@ -59,6 +67,9 @@ private:
     // Thread to run network on
     std::thread _thread;
 
+    // Threads serving connections
+    std::unique_ptr<Afina::Concurrency::Executor> _executor;
+
 
     std::mutex m;
     std::unordered_set<int> clients;
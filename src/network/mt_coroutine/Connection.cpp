@@ -0,0 +1,81 @@
+#include "Connection.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Network {
+namespace MTcoroutine {
+
+// See Connection.h
+Connection::~Connection() { close(_socket); }
+
+// Single block of data readed from the socket could trigger inside actions a multiple times,
+// for example:
+// - read#0: [<command1 start>]
+// - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
+void Connection::Process() {
+    size_t pos = 0;
+    try {
+        while (pos < _read_bytes) {
+            // There is no command yet
+            if (!_command) {
+                std::size_t parsed = 0;
+                if (_parser.Parse(_read_buffer + pos, _read_bytes - pos, parsed)) {
+                    _logger->debug("Found new command: {} in {} bytes", _parser.Name(), parsed);
+                    _command = _parser.Build(_arg_remains);
+                    if (_arg_remains > 0) {
+                        _arg_remains += 2;
+                    }
+                }
+
+                // Parsed might fails to consume any bytes from input stream, wait for more
+                if (parsed == 0) {
+                    break;
+                }
+                pos += parsed;
+            }
+
+            // There is command, but we still wait for argument to arrive...
+            if (_command && _arg_remains > 0) {
+                std::size_t to_read = std::min(_arg_remains, _read_bytes - pos);
+                _argument.append(_read_buffer + pos, to_read);
+                pos += to_read;
+                _arg_remains -= to_read;
+            }
+
+            // Thre is command & argument - RUN!
+            if (_command && _arg_remains == 0) {
+                if (_argument.size()) {
+                    _argument.resize(_argument.size() - 2);
+                }
+                _command->Execute(*_pStorage, _argument, _output);
+                _output.Append("\r\n");
+
+                // Prepare for the next command
+                _command = nullptr;
+                _argument.resize(0);
+                _parser.Reset();
+            }
+        }
+    } catch (std::runtime_error &ex) {
+        // Stream position is lost, so report error and close connection once it is sent
+        _logger->error("Failed to process command on descriptor {}: {}", _socket, ex.what());
+        _output.Append("CLIENT_ERROR " + std::string(ex.what()) + "\r\n");
+        _eof = true;
+        pos = _read_bytes;
+    }
+
+    std::memmove(_read_buffer, _read_buffer + pos, _read_bytes - pos);
+    _read_bytes -= pos;
+}
+
+} // namespace MTcoroutine
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,316 @@
+#include "ServerImpl.h"
+
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Counters.h>
+#include <afina/Storage.h>
+#include <afina/coroutine/Scheduler.h>
+#include <afina/logging/Service.h>
+
+#include "Connection.h"
+#include "Utils.h"
+
+namespace Afina {
+namespace Network {
+namespace MTcoroutine {
+
+// See Server.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _server_socket(-1), _event_fd(-1), _epoll_descr(-1), _running(false), _acceptor(nullptr) {}
+
+// See Server.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start mt_coroutine network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    // Create server socket
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    _server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    make_socket_non_blocking(_server_socket);
+    if (listen(_server_socket, SOMAXCONN) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    _epoll_descr = epoll_create1(0);
+    if (_epoll_descr == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (epoll_ctl(_epoll_descr, EPOLL_CTL_ADD, _event_fd, &event)) {
+        throw std::runtime_error("Failed to add file descriptor to epoll");
+    }
+
+    // Every coroutine gets own stack, so it could be suspended on one thread and resumed on another
+    _scheduler.reset(new Coroutine::Scheduler(
+        [this](Coroutine::Scheduler &scheduler, int timeout) { Poll(scheduler, timeout); }, kStackSize));
+    _running = true;
+    _scheduler->run([this]() { OnAccept(); });
+    _scheduler->Start(n_workers);
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+
+    // Wakeup threads that are sleep on epoll_wait
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup workers");
+    }
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    // Scheduler finishes once acceptor and all connections are done
+    _scheduler->Join();
+    _scheduler.reset();
+
+    close(_epoll_descr);
+    close(_event_fd);
+    _logger->warn("Network stopped");
+}
+
+void ServerImpl::OnAccept() {
+    _logger->info("Start acceptor");
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _acceptor = Coroutine::Scheduler::current();
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLONESHOT;
+    event.data.ptr = _acceptor;
+    if (epoll_ctl(_epoll_descr, EPOLL_CTL_ADD, _server_socket, &event)) {
+        throw std::runtime_error("Failed to add file descriptor to epoll");
+    }
+
+    while (_running) {
+        struct sockaddr in_addr;
+        socklen_t in_len;
+
+        // No need to make these sockets non blocking since accept4() takes care of it.
+        in_len = sizeof in_addr;
+        int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                // We have processed all incoming connections, sleep until there are more
+                if (!Wait(_server_socket, event, EPOLLIN)) {
+                    break;
+                }
+            } else {
+                _logger->error("Failed to accept socket");
+            }
+            continue;
+        }
+
+        // Print host and service info.
+        char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+        int retval =
+            getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
+        if (retval == 0) {
+            _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+        }
+
+        OnNewConnection(infd);
+    }
+
+    epoll_ctl(_epoll_descr, EPOLL_CTL_DEL, _server_socket, &event);
+    close(_server_socket);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _acceptor = nullptr;
+    }
+    _logger->warn("Acceptor stopped");
+}
+
+void ServerImpl::OnNewConnection(int infd) {
+    Connection *pc = new (std::nothrow) Connection(infd, pStorage, _logger);
+    if (pc == nullptr) {
+        throw std::runtime_error("Failed to allocate connection");
+    }
+
+    // Coroutine lands in the queue of this thread, idle ones steal it from there
+    _scheduler->run([this, pc]() { OnConnection(*pc); },
+                    [this, pc]() {
+                        _logger->error("No memory to serve connection on descriptor {}", pc->_socket);
+                        delete pc;
+                    });
+}
+
+void ServerImpl::OnConnection(Connection &pc) {
+    _logger->debug("Start connection on descriptor {}", pc._socket);
+    LocalCounters().total_connections.Add();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        pc._coroutine = Coroutine::Scheduler::current();
+        _connections.insert(&pc);
+    }
+
+    pc._event.events = EPOLLONESHOT;
+    pc._event.data.ptr = pc._coroutine;
+    if (epoll_ctl(_epoll_descr, EPOLL_CTL_ADD, pc._socket, &pc._event)) {
+        _logger->error("Failed to start connection on descriptor {}", pc._socket);
+        pc._eof = true;
+    }
+
+    while (pc.isAlive()) {
+        // Read whatever client has sent and execute it
+        if (!pc._eof) {
+            ssize_t readed_bytes =
+                read(pc._socket, pc._read_buffer + pc._read_bytes, sizeof(pc._read_buffer) - pc._read_bytes);
+            if (readed_bytes > 0) {
+                _logger->debug("Got {} bytes from socket", readed_bytes);
+                LocalCounters().bytes_read.Add(readed_bytes);
+                pc._read_bytes += readed_bytes;
+                pc.Process();
+            } else if (readed_bytes == 0) {
+                _logger->debug("Connection closed");
+                pc._eof = true;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                _logger->error("Failed to read from descriptor {}: {}", pc._socket, strerror(errno));
+                break;
+            } else if (pc._output.Empty() && !Wait(pc._socket, pc._event, EPOLLIN)) {
+                break;
+            }
+        }
+
+        // Send all the responses before reading more
+        if (!pc._output.Empty()) {
+            struct iovec iov[64];
+            ssize_t sent = writev(pc._socket, iov, pc._output.Fill(iov, 64));
+            if (sent > 0) {
+                LocalCounters().bytes_written.Add(sent);
+                pc._output.Consume(sent);
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                _logger->error("Failed to send response to descriptor {}: {}", pc._socket, strerror(errno));
+                break;
+            } else if (!Wait(pc._socket, pc._event, EPOLLOUT)) {
+                break;
+            }
+        }
+    }
+
+    _logger->debug("Close connection on descriptor {}", pc._socket);
+    LocalCounters().closed_connections.Add();
+    epoll_ctl(_epoll_descr, EPOLL_CTL_DEL, pc._socket, &pc._event);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _connections.erase(&pc);
+    }
+    delete &pc;
+}
+
+bool ServerImpl::Wait(int fd, struct epoll_event &event, uint32_t events) {
+    if (!_running) {
+        return false;
+    }
+
+    event.events = events | EPOLLONESHOT;
+    if (epoll_ctl(_epoll_descr, EPOLL_CTL_MOD, fd, &event)) {
+        _logger->error("Failed to change descriptor {} event mask", fd);
+        return false;
+    }
+
+    // Event could arrive before coroutine blocks, then block returns right away
+    _scheduler->block();
+    return _running;
+}
+
+void ServerImpl::Poll(Coroutine::Scheduler &scheduler, int timeout) {
+    // Coroutines are finishing, events of the ones already gone must not be looked at
+    if (!_running) {
+        std::this_thread::yield();
+        return;
+    }
+
+    std::array<struct epoll_event, 64> mod_list;
+    int nmod = epoll_wait(_epoll_descr, &mod_list[0], mod_list.size(), timeout);
+    if (nmod == -1 && errno != EINTR) {
+        throw std::runtime_error("Failed to wait for events: " + std::string(strerror(errno)));
+    }
+
+    // Descriptors are oneshot, so every event belongs to coroutine which is blocked or about to block
+    bool stop = false;
+    for (int i = 0; i < nmod; i++) {
+        if (mod_list[i].data.ptr != nullptr) {
+            scheduler.unblock(mod_list[i].data.ptr);
+        } else {
+            stop = true;
+        }
+    }
+    if (!stop) {
+        return;
+    }
+
+    // Stop signal: everybody wakes up and finds out server is stopping
+    _logger->debug("Break coroutines due to stop signal");
+    _running = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        scheduler.unblock(_acceptor);
+        for (Connection *pc : _connections) {
+            scheduler.unblock(pc->_coroutine);
+        }
+    }
+    scheduler.Stop();
+}
+
+} // namespace MTcoroutine
+} // namespace Network
+} // namespace Afina
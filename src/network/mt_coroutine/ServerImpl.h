@@ -0,0 +1,92 @@
+#ifndef AFINA_NETWORK_MT_COROUTINE_SERVER_H
+#define AFINA_NETWORK_MT_COROUTINE_SERVER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+struct epoll_event;
+
+namespace Afina {
+namespace Coroutine {
+class Scheduler;
+} // namespace Coroutine
+namespace Network {
+namespace MTcoroutine {
+
+// Forward declaration, see Connection.h
+class Connection;
+
+/**
+ * # Network resource manager implementation
+ * Same coroutine per connection as st_coroutine, but coroutines run on several threads of
+ * Coroutine::Scheduler. Every thread has own queue of ready coroutines and steals from others once
+ * it runs out of them. Idle thread waits on the shared epoll and unblocks coroutines got events.
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ~ServerImpl();
+
+    // See Server.h
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+protected:
+    void OnAccept();
+    void OnNewConnection(int);
+    void OnConnection(Connection &pc);
+
+    /**
+     * Blocks current coroutine until descriptor gets given events. Returns false if server is
+     * stopping and coroutine has to finish
+     */
+    bool Wait(int fd, struct epoll_event &event, uint32_t events);
+
+    // Called by idle scheduler thread
+    void Poll(Coroutine::Scheduler &scheduler, int timeout);
+
+private:
+    // Stack of every coroutine, guard page catches overflow
+    static const size_t kStackSize = 128 * 1024;
+
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Socket to accept new connection on
+    int _server_socket;
+
+    // Curstom event "device" used to wakeup workers
+    int _event_fd;
+
+    int _epoll_descr;
+    std::unique_ptr<Coroutine::Scheduler> _scheduler;
+    std::atomic<bool> _running;
+
+    // Guards coroutines below, so that stop doesn't wake up one which has already finished
+    std::mutex _mutex;
+
+    // Coroutine accepting new connections
+    void *_acceptor;
+
+    // Connections being served
+    std::unordered_set<Connection *> _connections;
+};
+
+} // namespace MTcoroutine
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_COROUTINE_SERVER_H
@@ -0,0 +1,14 @@
+#ifndef AFINA_NETWORK_MT_COROUTINE_UTILS_H
+#define AFINA_NETWORK_MT_COROUTINE_UTILS_H
+
+namespace Afina {
+namespace Network {
+namespace MTcoroutine {
+
+void make_socket_non_blocking(int sfd);
+
+} // namespace MTcoroutine
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_COROUTINE_UTILS_H
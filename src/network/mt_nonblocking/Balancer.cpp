@@ -0,0 +1,134 @@
+#include "Balancer.h"
+
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include <stdlib.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "Connection.h"
+
+namespace Afina {
+namespace Network {
+namespace MTnonblock {
+
+// See Balancer.h
+Balancer::Balancer(size_t workers) : _size(workers), _slots(nullptr) {
+    // Plain new doesn't respect alignment above the default one in C++11
+    void *mem = nullptr;
+    if (posix_memalign(&mem, kCacheLine, _size * sizeof(slot)) != 0) {
+        throw std::bad_alloc();
+    }
+
+    _slots = static_cast<slot *>(mem);
+    for (size_t i = 0; i < _size; i++) {
+        new (&_slots[i]) slot();
+    }
+
+    for (size_t i = 0; i < _size; i++) {
+        _slots[i].wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_slots[i].wakeup_fd == -1) {
+            std::string error = strerror(errno);
+            Destroy();
+            throw std::runtime_error("Failed to create eventfd: " + error);
+        }
+    }
+}
+
+// See Balancer.h
+Balancer::~Balancer() {
+    // Connections nobody has taken yet
+    for (size_t i = 0; i < _size; i++) {
+        Connection *conn = _slots[i].handoff.exchange(nullptr);
+        while (conn != nullptr) {
+            Connection *next = conn->_next_handoff;
+            delete conn;
+            conn = next;
+        }
+    }
+    Destroy();
+}
+
+void Balancer::Destroy() {
+    for (size_t i = 0; i < _size; i++) {
+        if (_slots[i].wakeup_fd != -1) {
+            close(_slots[i].wakeup_fd);
+        }
+        _slots[i].~slot();
+    }
+    free(_slots);
+}
+
+// See Balancer.h
+void Balancer::Push(size_t worker, Connection *conn) {
+    slot &target = _slots[worker];
+    target.connections.fetch_add(1, std::memory_order_relaxed);
+
+    Connection *head = target.handoff.load(std::memory_order_relaxed);
+    do {
+        conn->_next_handoff = head;
+    } while (!target.handoff.compare_exchange_weak(head, conn, std::memory_order_release, std::memory_order_relaxed));
+
+    // Worker is already woken up by someone else if queue wasn't empty
+    if (head == nullptr && eventfd_write(target.wakeup_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup worker");
+    }
+}
+
+// See Balancer.h
+Connection *Balancer::TakeAll(size_t worker) {
+    slot &target = _slots[worker];
+
+    eventfd_t value;
+    eventfd_read(target.wakeup_fd, &value);
+
+    // Stack keeps connections in reverse order
+    Connection *conn = target.handoff.exchange(nullptr, std::memory_order_acquire);
+    Connection *result = nullptr;
+    while (conn != nullptr) {
+        Connection *next = conn->_next_handoff;
+        conn->_next_handoff = result;
+        result = conn;
+        conn = next;
+    }
+    return result;
+}
+
+// See Balancer.h
+size_t Balancer::LeastLoaded() const {
+    size_t result = 0;
+    uint64_t best = Score(0);
+    for (size_t i = 1; i < _size; i++) {
+        uint64_t score = Score(i);
+        if (score < best) {
+            result = i;
+            best = score;
+        }
+    }
+    return result;
+}
+
+// See Balancer.h
+bool Balancer::Overloaded(size_t worker) const {
+    // Few events are not worth moving connections around
+    const uint64_t min_load = 64;
+
+    uint64_t load = _slots[worker].load.load(std::memory_order_relaxed);
+    if (load < min_load) {
+        return false;
+    }
+
+    for (size_t i = 0; i < _size; i++) {
+        if (2 * _slots[i].load.load(std::memory_order_relaxed) < load) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace MTnonblock
+} // namespace Network
+} // namespace Afina
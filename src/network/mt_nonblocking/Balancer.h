@@ -0,0 +1,103 @@
+#ifndef AFINA_NETWORK_MT_NONBLOCKING_BALANCER_H
+#define AFINA_NETWORK_MT_NONBLOCKING_BALANCER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Afina {
+namespace Network {
+namespace MTnonblock {
+
+// Forward declaration, see Connection.h
+class Connection;
+
+/**
+ * # Distributes connections between workers having own epolls
+ * Every worker has a handoff queue and an eventfd. Connection is given to the worker by pushing
+ * it to the queue and writing to eventfd, worker wakes up and registers connection in its epoll.
+ * Queue is a lock-free stack that worker takes all at once, so there is no ABA problem and
+ * pushers never wait for each other for long.
+ *
+ * Workers publish their load here: number of connections and number of events processed during
+ * the last balancing period. Acceptors place new connections to the least loaded worker, and
+ * overloaded worker moves its idle connections there as well.
+ *
+ * Thread safe implementation
+ */
+class Balancer {
+public:
+    Balancer(size_t workers);
+    ~Balancer();
+
+    size_t Size() const { return _size; }
+
+    /**
+     * Descriptor worker must poll to learn about new connections in its queue
+     */
+    int WakeupFd(size_t worker) const { return _slots[worker].wakeup_fd; }
+
+    /**
+     * Hands connection over to the worker and wakes it up. Connection must not be registered in
+     * any epoll
+     */
+    void Push(size_t worker, Connection *conn);
+
+    /**
+     * Takes all connections handed over to the worker, first pushed goes first. Must be called
+     * by the worker itself
+     */
+    Connection *TakeAll(size_t worker);
+
+    /**
+     * Worker with the least events processed during last period plus connections it has, so that
+     * idle connections are spread evenly as well
+     */
+    size_t LeastLoaded() const;
+
+    /**
+     * Publishes number of events processed by the worker during the last period
+     */
+    void ReportLoad(size_t worker, uint64_t events) { _slots[worker].load.store(events, std::memory_order_relaxed); }
+
+    /**
+     * Connection has left the worker
+     */
+    void Release(size_t worker) { _slots[worker].connections.fetch_sub(1, std::memory_order_relaxed); }
+
+    /**
+     * Returns true if worker processes more than twice as many events as some other one
+     */
+    bool Overloaded(size_t worker) const;
+
+private:
+    Balancer(const Balancer &) = delete;
+    Balancer &operator=(const Balancer &) = delete;
+
+    static const size_t kCacheLine = 64;
+
+    // Every slot is updated by its own worker, keep them in separate cache lines
+    struct alignas(kCacheLine) slot {
+        std::atomic<Connection *> handoff{nullptr};
+        std::atomic<uint64_t> load{0};
+        std::atomic<size_t> connections{0};
+        int wakeup_fd = -1;
+    };
+
+    inline uint64_t Score(size_t worker) const {
+        return _slots[worker].load.load(std::memory_order_relaxed) +
+               _slots[worker].connections.load(std::memory_order_relaxed);
+    }
+
+    // Closes eventfds and frees slots
+    void Destroy();
+
+    const size_t _size;
+    slot *_slots;
+};
+
+} // namespace MTnonblock
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_NONBLOCKING_BALANCER_H
@@ -1,25 +1,199 @@
 #include "Connection.h"
 
-#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Counters.h>
+#include <afina/Storage.h>
 
 namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
 // See Connection.h
-void Connection::Start() { std::cout << "Start" << std::endl; }
+Connection::~Connection() {
+    close(_socket);
+    LocalCounters().closed_connections.Add();
+}
+
+// See Connection.h
+void Connection::Start() {
+    _logger->debug("Start connection on descriptor {}", _socket);
+    LocalCounters().total_connections.Add();
+    UpdateEvents();
+}
 
 // See Connection.h
-void Connection::OnError() { std::cout << "OnError" << std::endl; }
+void Connection::OnError() {
+    _logger->debug("Error on descriptor {}", _socket);
+    _alive = false;
+}
 
 // See Connection.h
-void Connection::OnClose() { std::cout << "OnClose" << std::endl; }
+void Connection::OnClose() {
+    // Client could close its side right after the last command, so there is still data to read
+    // and responses to send
+    _logger->debug("Client closed descriptor {}", _socket);
+    DoRead();
+}
 
 // See Connection.h
-void Connection::DoRead() { std::cout << "DoRead" << std::endl; }
+void Connection::DoRead() {
+    try {
+        // Buffer could be filled up by commands waiting for output to be drained
+        if (_read_bytes < sizeof(_read_buffer)) {
+            ssize_t readed_bytes = read(_socket, _read_buffer + _read_bytes, sizeof(_read_buffer) - _read_bytes);
+            if (readed_bytes > 0) {
+                _logger->debug("Got {} bytes from socket", readed_bytes);
+                LocalCounters().bytes_read.Add(readed_bytes);
+                _read_bytes += readed_bytes;
+            } else if (readed_bytes == 0) {
+                _logger->debug("Connection closed");
+                _eof = true;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                throw std::runtime_error(std::string(strerror(errno)));
+            }
+        }
+
+        Execute();
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+        _alive = false;
+    }
+    UpdateEvents();
+}
 
 // See Connection.h
-void Connection::DoWrite() { std::cout << "DoWrite" << std::endl; }
+void Connection::DoWrite() {
+    try {
+        Flush();
+
+        // Reading was paused, there could be commands left in the buffer
+        if (_output.Empty()) {
+            Execute();
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+        _alive = false;
+    }
+    UpdateEvents();
+}
+
+// Single block of data readed from the socket could trigger inside actions a multiple times,
+// for example:
+// - read#0: [<command1 start>]
+// - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
+void Connection::Process() {
+    size_t pos = 0;
+    try {
+        while (pos < _read_bytes && _queued < kMaxQueued) {
+            // There is no command yet
+            if (!_command) {
+                std::size_t parsed = 0;
+                if (_parser.Parse(_read_buffer + pos, _read_bytes - pos, parsed)) {
+                    _logger->debug("Found new command: {} in {} bytes", _parser.Name(), parsed);
+                    _command = _parser.Build(_arg_remains);
+                    if (_arg_remains > 0) {
+                        _arg_remains += 2;
+                    }
+                }
+
+                // Parsed might fails to consume any bytes from input stream, wait for more
+                if (parsed == 0) {
+                    break;
+                }
+                pos += parsed;
+            }
+
+            // There is command, but we still wait for argument to arrive...
+            if (_command && _arg_remains > 0) {
+                std::size_t to_read = std::min(_arg_remains, _read_bytes - pos);
+                _argument.append(_read_buffer + pos, to_read);
+                pos += to_read;
+                _arg_remains -= to_read;
+            }
+
+            // Thre is command & argument - RUN!
+            if (_command && _arg_remains == 0) {
+                if (_argument.size()) {
+                    _argument.resize(_argument.size() - 2);
+                }
+                _command->Execute(*_pStorage, _argument, _output);
+                _output.Append("\r\n");
+                _queued++;
+
+                // Prepare for the next command
+                _command = nullptr;
+                _argument.resize(0);
+                _parser.Reset();
+            }
+        }
+    } catch (std::runtime_error &ex) {
+        // Stream position is lost, so report error and close connection once it is sent
+        _logger->error("Failed to process command on descriptor {}: {}", _socket, ex.what());
+        _output.Append("CLIENT_ERROR " + std::string(ex.what()) + "\r\n");
+        _eof = true;
+        pos = _read_bytes;
+    }
+
+    std::memmove(_read_buffer, _read_buffer + pos, _read_bytes - pos);
+    _read_bytes -= pos;
+}
+
+void Connection::Execute() {
+    for (;;) {
+        size_t left = _read_bytes;
+        Process();
+        Flush();
+
+        // Once output is sent there could be more commands, client may wait for responses and
+        // send nothing until then
+        if (!_output.Empty() || _read_bytes == 0 || _read_bytes == left) {
+            break;
+        }
+    }
+}
+
+void Connection::Flush() {
+    while (!_output.Empty()) {
+        struct iovec iov[IOV_MAX];
+        ssize_t sent = writev(_socket, iov, _output.Fill(iov, IOV_MAX));
+        if (sent > 0) {
+            LocalCounters().bytes_written.Add(sent);
+            _output.Consume(sent);
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            throw std::runtime_error("Failed to send response: " + std::string(strerror(errno)));
+        }
+    }
+
+    if (_output.Empty()) {
+        _queued = 0;
+    }
+}
+
+void Connection::UpdateEvents() {
+    if (_eof && _output.Empty()) {
+        _alive = false;
+    }
+
+    _event.events = 0;
+    if (!_eof && _queued < kMaxQueued) {
+        _event.events |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (!_output.Empty()) {
+        _event.events |= EPOLLOUT;
+    }
+}
 
 } // namespace MTnonblock
 } // namespace Network
@@ -2,21 +2,51 @@
 #define AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 
 #include <cstring>
+#include <memory>
+#include <string>
 
 #include <sys/epoll.h>
 
+#include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+
+#include "protocol/Parser.h"
+
+namespace spdlog {
+class logger;
+}
+
 namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
 namespace Network {
 namespace MTnonblock {
 
+/**
+ * # Client connection served by workers
+ * Connection is registered in epoll with EPOLLONESHOT, so only one worker at a time could
+ * process its events and state needs no locks.
+ *
+ * Every read executes all the commands which are complete in the buffer, responses are
+ * accumulated in the output queue and the whole queue is sent by a single writev. Once client
+ * gets too far ahead of what it reads back, connection stops reading until output is drained.
+ */
 class Connection {
 public:
-    Connection(int s) : _socket(s) {
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl)
+        : _socket(s), _pStorage(ps), _logger(pl), _alive(true), _eof(false), _read_bytes(0), _command(nullptr),
+          _arg_remains(0), _queued(0), _next_handoff(nullptr), _last_active(0) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _event.data.ptr = this;
     }
+    ~Connection();
 
-    inline bool isAlive() const { return true; }
+    inline bool isAlive() const { return _alive; }
+
+    // Connection has no half done work, so it could be moved to another worker
+    inline bool isIdle() const { return _output.Empty() && _read_bytes == 0 && !_command; }
 
     void Start();
 
@@ -27,11 +57,56 @@ protected:
     void DoWrite();
 
 private:
+    friend class Balancer;
     friend class Worker;
     friend class ServerImpl;
 
+    // Max number of responses waiting in the output queue before connection stops reading
+    static const size_t kMaxQueued = 128;
+
+    // Executes complete commands from the read buffer and sends responses while output keeps up
+    void Execute();
+
+    // Executes complete commands in the read buffer until output queue is full
+    void Process();
+
+    // Sends as much of the output queue as socket takes
+    void Flush();
+
+    // Decides what events connection waits for next
+    void UpdateEvents();
+
     int _socket;
     struct epoll_event _event;
+
+    std::shared_ptr<Afina::Storage> _pStorage;
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Connection must be destroyed once worker is done with it
+    bool _alive;
+
+    // Nothing more is going to be read, connection is closed once output is sent
+    bool _eof;
+
+    // Bytes read from the socket but not parsed yet
+    char _read_buffer[16384];
+    size_t _read_bytes;
+
+    // Command being parsed and its argument, command object is owned and reused by the parser
+    Protocol::Parser _parser;
+    Execute::Command *_command;
+    std::size_t _arg_remains;
+    std::string _argument;
+
+    // Responses which are not sent yet
+    Execute::Response _output;
+    size_t _queued;
+
+    // Link in the handoff queue of the worker
+    Connection *_next_handoff;
+
+    // Balancing period of the worker when connection got its last event
+    uint64_t _last_active;
 };
 
 } // namespace MTnonblock
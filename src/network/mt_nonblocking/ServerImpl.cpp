@@ -1,14 +1,17 @@
 #include "ServerImpl.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <vector>
 
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <sched.h>
 #include <signal.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
@@ -21,6 +24,7 @@
 #include <afina/Storage.h>
 #include <afina/logging/Service.h>
 
+#include "Balancer.h"
 #include "Connection.h"
 #include "Utils.h"
 #include "Worker.h"
@@ -29,8 +33,29 @@ namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
+namespace {
+
+// CPUs the process is allowed to run on, could be a subset of all of them in a container or
+// under taskset
+std::vector<size_t> AllowedCpus() {
+    std::vector<size_t> result;
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0) {
+        for (size_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &cpus)) {
+                result.push_back(cpu);
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, Mode mode)
+    : Server(ps, pl), _server_socket(-1), _data_epoll_fd(-1), _event_fd(-1), _mode(mode) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -47,57 +72,75 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Unable to mask SIGPIPE");
     }
 
-    // Create server socket
-    struct sockaddr_in server_addr;
-    std::memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;         // IPv4
-    server_addr.sin_port = htons(port);       // TCP port number
-    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
-
-    _server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (_server_socket == -1) {
-        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
-    int opts = 1;
-    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
-    }
+    if (_mode != Mode::Shared) {
+        // Every worker gets own epoll, stop signal is delivered to all of them
+        if (_mode == Mode::Balanced) {
+            _balancer.reset(new Balancer(n_workers));
+        }
 
-    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
-    }
+        std::vector<size_t> cpus = AllowedCpus();
+        _workers.reserve(n_workers);
+        for (uint32_t i = 0; i < n_workers; i++) {
+            int worker_epoll = epoll_create1(0);
+            if (worker_epoll == -1) {
+                throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+            }
+            _worker_epolls.push_back(worker_epoll);
 
-    make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
-    }
+            struct epoll_event event;
+            event.events = EPOLLIN;
+            event.data.ptr = nullptr;
+            if (epoll_ctl(worker_epoll, EPOLL_CTL_ADD, _event_fd, &event)) {
+                throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+            }
 
-    // Start IO workers
-    _data_epoll_fd = epoll_create1(0);
-    if (_data_epoll_fd == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
-    }
+            _workers.emplace_back(pStorage, pLogging);
+            if (_mode == Mode::Balanced) {
+                _workers.back().Start(worker_epoll, *_balancer, i);
+            } else {
+                int worker_socket = Listen(port);
+                _worker_sockets.push_back(worker_socket);
+                _workers.back().Start(worker_epoll, worker_socket);
+
+                // Connection never leaves its worker, so with the worker pinned it is served by one
+                // core and core local storage data stays in that core cache
+                if (!cpus.empty()) {
+                    _workers.back().Pin(cpus[i % cpus.size()]);
+                }
+            }
+        }
 
-    _event_fd = eventfd(0, EFD_NONBLOCK);
-    if (_event_fd == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+        if (_mode == Mode::ReusePort) {
+            return;
+        }
     }
 
-    struct epoll_event event;
-    event.events = EPOLLIN;
-    event.data.ptr = nullptr;
-    if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
-        throw std::runtime_error("Failed to add eventfd descriptor to epoll");
-    }
+    _server_socket = Listen(port);
 
-    _workers.reserve(n_workers);
-    for (int i = 0; i < n_workers; i++) {
-        _workers.emplace_back(pStorage, pLogging);
-        _workers.back().Start(_data_epoll_fd);
+    // Start IO workers
+    if (_mode == Mode::Shared) {
+        _data_epoll_fd = epoll_create1(0);
+        if (_data_epoll_fd == -1) {
+            throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+        }
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+            throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+        }
+
+        _workers.reserve(n_workers);
+        for (uint32_t i = 0; i < n_workers; i++) {
+            _workers.emplace_back(pStorage, pLogging);
+            _workers.back().Start(_data_epoll_fd);
+        }
     }
 
     // Start acceptors
@@ -130,6 +173,54 @@ void ServerImpl::Join() {
     for (auto &w : _workers) {
         w.Join();
     }
+
+    for (int fd : _worker_sockets) {
+        close(fd);
+    }
+    for (int fd : _worker_epolls) {
+        close(fd);
+    }
+    _worker_sockets.clear();
+    _worker_epolls.clear();
+    _balancer.reset();
+}
+
+// See ServerImpl.h
+int ServerImpl::Listen(uint16_t port) {
+    // Create server socket
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    int server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    if (setsockopt(server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
+        close(server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (_mode == Mode::ReusePort && setsockopt(server_socket, SOL_SOCKET, SO_REUSEPORT, &opts, sizeof(opts)) == -1) {
+        close(server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    make_socket_non_blocking(server_socket);
+    if (listen(server_socket, SOMAXCONN) == -1) {
+        close(server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+    return server_socket;
 }
 
 // See ServerImpl.h
@@ -193,13 +284,19 @@ void ServerImpl::OnRun() {
                 }
 
                 // Register the new FD to be monitored by epoll.
-                Connection *pc = new Connection(infd);
+                Connection *pc = new Connection(infd, pStorage, _logger);
                 if (pc == nullptr) {
                     throw std::runtime_error("Failed to allocate connection");
                 }
 
-                // Register connection in worker's epoll
+                // Hand connection over to the least loaded worker
                 pc->Start();
+                if (_balancer) {
+                    _balancer->Push(_balancer->LeastLoaded(), pc);
+                    continue;
+                }
+
+                // Register connection in worker's epoll
                 if (pc->isAlive()) {
                     pc->_event.events |= EPOLLONESHOT;
                     int epoll_ctl_retval;
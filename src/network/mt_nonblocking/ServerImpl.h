@@ -1,6 +1,7 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 #define AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -16,14 +17,25 @@ namespace MTnonblock {
 
 // Forward declaration, see Worker.h
 class Worker;
+class Balancer;
 
 /**
  * # Network resource manager implementation
  * Epoll based server
+ *
+ * In Shared mode acceptors put connections into the epoll shared by all workers, so connection
+ * has to be rearmed after each event. Other modes give every worker own epoll, connection
+ * stays registered there while its interest doesn't change, so there is no syscall to rearm it:
+ * - ReusePort: every worker has own listening socket bound with SO_REUSEPORT, kernel spreads
+ *   connections between sockets and connection is served by the same worker all its life
+ * - Balanced: acceptors hand connections over to the least loaded worker through the Balancer
+ *   queues, overloaded worker moves its idle connections to others
  */
 class ServerImpl : public Server {
 public:
-    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    enum class Mode { Shared, ReusePort, Balanced };
+
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, Mode mode = Mode::Shared);
     ~ServerImpl();
 
     // See Server.h
@@ -39,6 +51,9 @@ protected:
     void OnRun();
     void OnNewConnection();
 
+    // Creates non blocking socket listening the given port
+    int Listen(uint16_t port);
+
 private:
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
@@ -63,6 +78,16 @@ private:
 
     // threads serving read/write requests
     std::vector<Worker> _workers;
+
+    // How connections are distributed between workers
+    const Mode _mode;
+
+    // Sockets and epolls owned by workers in ReusePort and Balanced modes
+    std::vector<int> _worker_sockets;
+    std::vector<int> _worker_epolls;
+
+    // Handoff queues of workers in Balanced mode
+    std::unique_ptr<Balancer> _balancer;
 };
 
 } // namespace MTnonblock
@@ -1,10 +1,17 @@
 #include "Worker.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 
 #include <netdb.h>
+#include <pthread.h>
+#include <sched.h>
 #include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
@@ -13,6 +20,7 @@
 
 #include <afina/logging/Service.h>
 
+#include "Balancer.h"
 #include "Connection.h"
 #include "Utils.h"
 
@@ -20,9 +28,17 @@ namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
+namespace {
+
+// How often overloaded worker gives its idle connections away
+const std::chrono::milliseconds kBalancePeriod(100);
+
+} // namespace
+
 // See Worker.h
 Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
-    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1) {
+    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1), _server_socket(-1), _balancer(nullptr), _id(0),
+      _period(0), _events(0) {
     // TODO: implementation here
 }
 
@@ -41,21 +57,73 @@ Worker &Worker::operator=(Worker &&other) {
     _logger = std::move(other._logger);
     _thread = std::move(other._thread);
     _epoll_fd = other._epoll_fd;
+    _server_socket = other._server_socket;
+    _balancer = other._balancer;
+    _id = other._id;
+    _connections = std::move(other._connections);
+    _period = other._period;
+    _period_start = other._period_start;
+    _events = other._events;
 
     other._epoll_fd = -1;
+    other._server_socket = -1;
+    other._balancer = nullptr;
     return *this;
 }
 
 // See Worker.h
-void Worker::Start(int epoll_fd) {
+void Worker::Start(int epoll_fd, int server_socket) {
     if (isRunning.exchange(true) == false) {
         assert(_epoll_fd == -1);
         _epoll_fd = epoll_fd;
+        _server_socket = server_socket;
         _logger = _pLogging->select("network.worker");
+
+        // Worker itself is the marker of the server socket events
+        if (_server_socket != -1) {
+            struct epoll_event event;
+            event.events = EPOLLIN;
+            event.data.ptr = this;
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _server_socket, &event)) {
+                throw std::runtime_error("Failed to add server socket to epoll");
+            }
+        }
         _thread = std::thread(&Worker::OnRun, this);
     }
 }
 
+// See Worker.h
+void Worker::Start(int epoll_fd, Balancer &balancer, size_t id) {
+    if (isRunning.exchange(true) == false) {
+        assert(_epoll_fd == -1);
+        _epoll_fd = epoll_fd;
+        _balancer = &balancer;
+        _id = id;
+        _period_start = std::chrono::steady_clock::now();
+        _logger = _pLogging->select("network.worker");
+
+        // Balancer is the marker of the handoff queue events
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = _balancer;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _balancer->WakeupFd(_id), &event)) {
+            throw std::runtime_error("Failed to add handoff eventfd to epoll");
+        }
+        _thread = std::thread(&Worker::OnRun, this);
+    }
+}
+
+// See Worker.h
+void Worker::Pin(size_t cpu) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    int err = pthread_setaffinity_np(_thread.native_handle(), sizeof(cpus), &cpus);
+    if (err != 0) {
+        _logger->warn("Failed to pin worker to CPU {}: {}", cpu, strerror(err));
+    }
+}
+
 // See Worker.h
 void Worker::Stop() { isRunning = false; }
 
@@ -74,7 +142,8 @@ void Worker::OnRun() {
     //
     // Do not forget to use EPOLLEXCLUSIVE flag when register socket
     // for events to avoid thundering herd type behavior.
-    int timeout = -1;
+    bool own_epoll = _server_socket != -1 || _balancer != nullptr;
+    int timeout = _balancer != nullptr ? kBalancePeriod.count() : -1;
     std::array<struct epoll_event, 64> mod_list;
     while (isRunning) {
         int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), timeout);
@@ -90,8 +159,21 @@ void Worker::OnRun() {
                 continue;
             }
 
+            if (current_event.data.ptr == this) {
+                OnAccept();
+                continue;
+            }
+
+            if (_balancer != nullptr && current_event.data.ptr == _balancer) {
+                OnHandoff();
+                continue;
+            }
+
             // Some connection gets new data
             Connection *pconn = static_cast<Connection *>(current_event.data.ptr);
+            uint32_t interest = pconn->_event.events;
+            pconn->_last_active = _period;
+            _events++;
             if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
                 _logger->debug("Got EPOLLERR or EPOLLHUP, value of returned events: {}", current_event.events);
                 pconn->OnError();
@@ -110,8 +192,20 @@ void Worker::OnRun() {
                 }
             }
 
+            // Connection in the own epoll stays armed, update it only if it wants something else
+            if (own_epoll) {
+                if (pconn->isAlive() && pconn->_event.events != interest &&
+                    epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event)) {
+                    _logger->debug("epoll_ctl failed during connection update: error {}", errno);
+                    pconn->OnError();
+                }
+                if (!pconn->isAlive()) {
+                    Unregister(pconn);
+                    delete pconn;
+                }
+            }
             // Rearm connection
-            if (pconn->isAlive()) {
+            else if (pconn->isAlive()) {
                 pconn->_event.events |= EPOLLONESHOT;
                 int epoll_ctl_retval;
                 if ((epoll_ctl_retval = epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event))) {
@@ -128,11 +222,118 @@ void Worker::OnRun() {
                 delete pconn;
             }
         }
-        // TODO: Select timeout...
+
+        if (_balancer != nullptr) {
+            Balance();
+        }
+    }
+
+    // Connections of the own epoll are not reachable by anyone else
+    while (!_connections.empty()) {
+        Connection *pconn = *_connections.begin();
+        Unregister(pconn);
+        delete pconn;
     }
     _logger->warn("Worker stopped");
 }
 
+// See Worker.h
+void Worker::OnAccept() {
+    for (;;) {
+        int infd = accept4(_server_socket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                _logger->error("Failed to accept socket");
+            }
+            break;
+        }
+        _logger->debug("Accepted connection on descriptor {}", infd);
+
+        Connection *pc = new Connection(infd, _pStorage, _logger);
+        pc->Start();
+        Register(pc);
+    }
+}
+
+// See Worker.h
+void Worker::OnHandoff() {
+    Connection *pconn = _balancer->TakeAll(_id);
+    while (pconn != nullptr) {
+        Connection *next = pconn->_next_handoff;
+        pconn->_next_handoff = nullptr;
+        Register(pconn);
+        pconn = next;
+    }
+}
+
+// See Worker.h
+void Worker::Balance() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - _period_start < kBalancePeriod) {
+        return;
+    }
+
+    _balancer->ReportLoad(_id, _events);
+    _period_start = now;
+    _events = 0;
+    _period++;
+
+    if (!_balancer->Overloaded(_id)) {
+        return;
+    }
+
+    size_t target = _balancer->LeastLoaded();
+    if (target == _id) {
+        return;
+    }
+
+    // Connections that got no events during the whole last period and have nothing in flight
+    std::vector<Connection *> idle;
+    for (Connection *pconn : _connections) {
+        if (pconn->isIdle() && pconn->_last_active + 1 < _period) {
+            idle.push_back(pconn);
+        }
+    }
+
+    // Give away half of them, so that workers don't swap the same connections back and forth
+    idle.resize(idle.size() / 2);
+    if (idle.empty()) {
+        return;
+    }
+
+    _logger->debug("Worker {} is overloaded, move {} connections to worker {}", _id, idle.size(), target);
+    for (Connection *pconn : idle) {
+        Unregister(pconn);
+        _balancer->Push(target, pconn);
+    }
+}
+
+// See Worker.h
+void Worker::Register(Connection *pconn) {
+    pconn->_last_active = _period;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, pconn->_socket, &pconn->_event)) {
+        _logger->debug("epoll_ctl failed during connection register: error {}", errno);
+        pconn->OnError();
+        if (_balancer != nullptr) {
+            _balancer->Release(_id);
+        }
+        delete pconn;
+        return;
+    }
+    _connections.insert(pconn);
+}
+
+// See Worker.h
+void Worker::Unregister(Connection *pconn) {
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
+        _logger->debug("epoll_ctl failed during connection unregister: error {}", errno);
+    }
+    _connections.erase(pconn);
+    if (_balancer != nullptr) {
+        _balancer->Release(_id);
+    }
+}
+
 } // namespace MTnonblock
 } // namespace Network
 } // namespace Afina
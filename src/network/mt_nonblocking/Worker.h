@@ -2,8 +2,11 @@
 #define AFINA_NETWORK_MT_NONBLOCKING_WORKER_H
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <thread>
+#include <unordered_set>
 
 namespace spdlog {
 class logger;
@@ -20,6 +23,10 @@ class Service;
 namespace Network {
 namespace MTnonblock {
 
+// Forward declaration, see Balancer.h
+class Balancer;
+class Connection;
+
 /**
  * # Thread running epoll
  * On Start spaws background thread that is doing epoll on the given server
@@ -37,8 +44,23 @@ public:
      * Spaws new background thread that is doing epoll on the given server
      * socket. Once connection accepted it must be registered and being processed
      * on this thread
+     *
+     * If server socket is given, epoll belongs to this worker only: worker accepts connections
+     * from the socket itself and keeps them registered without EPOLLONESHOT
+     */
+    void Start(int epoll_fd, int server_socket = -1);
+
+    /**
+     * Same as above, but new connections are taken from the handoff queue of the balancer. Once
+     * worker is overloaded its idle connections are moved to the least loaded worker
      */
-    void Start(int epoll_fd);
+    void Start(int epoll_fd, Balancer &balancer, size_t id);
+
+    /**
+     * Binds running worker thread to the given CPU, so that per CPU data it touches stays in the
+     * cache of one core. Failure is not fatal, worker just keeps running wherever scheduler puts it
+     */
+    void Pin(size_t cpu);
 
     /**
      * Signal background thread to stop. After that signal thread must stop to
@@ -60,6 +82,28 @@ protected:
      */
     void OnRun();
 
+    /**
+     * Accepts all pending connections from the own server socket
+     */
+    void OnAccept();
+
+    /**
+     * Registers connections handed over by the balancer
+     */
+    void OnHandoff();
+
+    /**
+     * Publishes load once balancing period is over and moves idle connections away if worker
+     * is overloaded
+     */
+    void Balance();
+
+    // Adds connection to the own epoll
+    void Register(Connection *pconn);
+
+    // Removes connection from the own epoll, it is up to caller what to do with it next
+    void Unregister(Connection *pconn);
+
 private:
     Worker(Worker &) = delete;
     Worker &operator=(Worker &) = delete;
@@ -81,6 +125,21 @@ private:
 
     // EPOLL descriptor using for events processing
     int _epoll_fd;
+
+    // Socket to accept connections on if epoll is owned by this worker, -1 otherwise
+    int _server_socket;
+
+    // Source of connections if epoll is owned by this worker and balanced with others
+    Balancer *_balancer;
+    size_t _id;
+
+    // Connections registered in the own epoll
+    std::unordered_set<Connection *> _connections;
+
+    // Current balancing period, its start and number of events processed during it
+    uint64_t _period;
+    std::chrono::steady_clock::time_point _period_start;
+    uint64_t _events;
 };
 
 } // namespace MTnonblock
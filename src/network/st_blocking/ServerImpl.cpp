@@ -13,12 +13,15 @@
 #include <signal.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <spdlog/logger.h>
 
+#include <afina/Counters.h>
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
 #include <afina/logging/Service.h>
 
 #include "protocol/Parser.h"
@@ -122,13 +125,13 @@ void ServerImpl::Join() {
 void ServerImpl::OnRun() {
     // Here is connection state
     // - parser: parse state of the stream
-    // - command_to_execute: last command parsed out of stream
+    // - command_to_execute: last command parsed out of stream, owned by the parser
     // - arg_remains: how many bytes to read from stream to get command argument
     // - argument_for_command: buffer stores argument
     std::size_t arg_remains;
     Protocol::Parser parser;
     std::string argument_for_command;
-    std::unique_ptr<Execute::Command> command_to_execute;
+    Execute::Command *command_to_execute = nullptr;
     while (running.load()) {
         _logger->debug("waiting for connection...");
 
@@ -161,6 +164,8 @@ void ServerImpl::OnRun() {
             setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof tv);
         }
 
+        LocalCounters().total_connections.Add();
+
         // Process new connection:
         // - read commands until socket alive
         // - execute each command
@@ -170,6 +175,7 @@ void ServerImpl::OnRun() {
             char client_buffer[4096];
             while ((readed_bytes = read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
                 _logger->debug("Got {} bytes from socket", readed_bytes);
+                LocalCounters().bytes_read.Add(readed_bytes);
 
                 // Single block of data readed from the socket could trigger inside actions a multiple times,
                 // for example:
@@ -216,20 +222,26 @@ void ServerImpl::OnRun() {
                     if (command_to_execute && arg_remains == 0) {
                         _logger->debug("Start command execution");
 
-                        std::string result;
+                        Execute::Response result;
                         if (argument_for_command.size()) {
                             argument_for_command.resize(argument_for_command.size() - 2);
                         }
                         command_to_execute->Execute(*pStorage, argument_for_command, result);
 
-                        // Send response
-                        result += "\r\n";
-                        if (send(client_socket, result.data(), result.size(), 0) <= 0) {
-                            throw std::runtime_error("Failed to send response");
+                        // Send response, values are written right from the storage memory
+                        result.Append("\r\n");
+                        while (!result.Empty()) {
+                            struct iovec iov[64];
+                            ssize_t sent = writev(client_socket, iov, result.Fill(iov, 64));
+                            if (sent <= 0) {
+                                throw std::runtime_error("Failed to send response");
+                            }
+                            LocalCounters().bytes_written.Add(sent);
+                            result.Consume(sent);
                         }
 
                         // Prepare for the next command
-                        command_to_execute.reset();
+                        command_to_execute = nullptr;
                         argument_for_command.resize(0);
                         parser.Reset();
                     }
@@ -247,9 +259,10 @@ void ServerImpl::OnRun() {
 
         // We are done with this connection
         close(client_socket);
+        LocalCounters().closed_connections.Add();
 
         // Prepare for the next command: just in case if connection was closed in the middle of executing something
-        command_to_execute.reset();
+        command_to_execute = nullptr;
         argument_for_command.resize(0);
         parser.Reset();
     }
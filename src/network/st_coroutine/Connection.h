@@ -2,35 +2,78 @@
 #define AFINA_NETWORK_ST_COROUTINE_CONNECTION_H
 
 #include <cstring>
+#include <memory>
+#include <string>
 
 #include <sys/epoll.h>
 
+#include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+
+#include "protocol/Parser.h"
+
+namespace spdlog {
+class logger;
+}
+
 namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
 namespace Network {
 namespace STcoroutine {
 
+/**
+ * # Client connection served by its own coroutine
+ * Coroutine reads, executes and writes in a plain loop. Once socket isn't ready it registers itself
+ * in epoll and blocks, server loop unblocks it when event arrives. All the state lives here rather
+ * than on the coroutine stack, so switches copy as little as possible.
+ */
 class Connection {
 public:
-    Connection(int s) : _socket(s) {
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl)
+        : _socket(s), _pStorage(ps), _logger(pl), _coroutine(nullptr), _eof(false), _read_bytes(0),
+          _command(nullptr), _arg_remains(0) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
-        _event.data.ptr = this;
     }
+    ~Connection();
 
-    inline bool isAlive() const { return true; }
-
-    void Start();
+    inline bool isAlive() const { return !_eof || !_output.Empty(); }
 
 protected:
-    void OnError();
-    void OnClose();
-    void DoRead();
-    void DoWrite();
+    /**
+     * Executes all complete commands in the read buffer
+     */
+    void Process();
 
 private:
     friend class ServerImpl;
 
     int _socket;
     struct epoll_event _event;
+
+    std::shared_ptr<Afina::Storage> _pStorage;
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Coroutine serving connection
+    void *_coroutine;
+
+    // Nothing more is going to be read, connection is closed once output is sent
+    bool _eof;
+
+    // Bytes read from the socket but not parsed yet
+    char _read_buffer[4096];
+    size_t _read_bytes;
+
+    // Command being parsed and its argument, command object is owned and reused by the parser
+    Protocol::Parser _parser;
+    Execute::Command *_command;
+    std::size_t _arg_remains;
+    std::string _argument;
+
+    // Responses which are not sent yet
+    Execute::Response _output;
 };
 
 } // namespace STcoroutine
@@ -1,5 +1,6 @@
 #include "ServerImpl.h"
 
+#include <array>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -14,11 +15,14 @@
 #include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <spdlog/logger.h>
 
+#include <afina/Counters.h>
 #include <afina/Storage.h>
+#include <afina/coroutine/Engine.h>
 #include <afina/logging/Service.h>
 
 #include "Connection.h"
@@ -29,7 +33,8 @@ namespace Network {
 namespace STcoroutine {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _epoll_descr(-1), _engine(nullptr), _running(false), _acceptor(nullptr) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -37,7 +42,7 @@ ServerImpl::~ServerImpl() {}
 // See Server.h
 void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
     _logger = pLogging->select("network");
-    _logger->info("Start st_nonblocking network service");
+    _logger->info("Start st_coroutine network service");
 
     sigset_t sig_mask;
     sigemptyset(&sig_mask);
@@ -70,7 +75,7 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
     }
 
     make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
+    if (listen(_server_socket, SOMAXCONN) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
     }
@@ -102,87 +107,46 @@ void ServerImpl::Join() {
 // See ServerImpl.h
 void ServerImpl::OnRun() {
     _logger->info("Start acceptor");
-    int epoll_descr = epoll_create1(0);
-    if (epoll_descr == -1) {
+    _epoll_descr = epoll_create1(0);
+    if (_epoll_descr == -1) {
         throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
     struct epoll_event event;
     event.events = EPOLLIN;
-    event.data.fd = _server_socket;
-    if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, _server_socket, &event)) {
+    event.data.ptr = nullptr;
+    if (epoll_ctl(_epoll_descr, EPOLL_CTL_ADD, _event_fd, &event)) {
         throw std::runtime_error("Failed to add file descriptor to epoll");
     }
 
-    struct epoll_event event2;
-    event2.events = EPOLLIN;
-    event2.data.fd = _event_fd;
-    if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, _event_fd, &event2)) {
-        throw std::runtime_error("Failed to add file descriptor to epoll");
-    }
-
-    bool run = true;
-    std::array<struct epoll_event, 64> mod_list;
-    while (run) {
-        int nmod = epoll_wait(epoll_descr, &mod_list[0], mod_list.size(), -1);
-        _logger->debug("Acceptor wokeup: {} events", nmod);
-
-        for (int i = 0; i < nmod; i++) {
-            struct epoll_event &current_event = mod_list[i];
-            if (current_event.data.fd == _event_fd) {
-                _logger->debug("Break acceptor due to stop signal");
-                run = false;
-                continue;
-            } else if (current_event.data.fd == _server_socket) {
-                OnNewConnection(epoll_descr);
-                continue;
-            }
-
-            // That is some connection!
-            Connection *pc = static_cast<Connection *>(current_event.data.ptr);
-
-            auto old_mask = pc->_event.events;
-            if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
-                pc->OnError();
-            } else if (current_event.events & EPOLLRDHUP) {
-                pc->OnClose();
-            } else {
-                // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) {
-                    pc->DoRead();
-                }
-                if (current_event.events & EPOLLOUT) {
-                    pc->DoWrite();
-                }
-            }
-
-            // Does it alive?
-            if (!pc->isAlive()) {
-                if (epoll_ctl(epoll_descr, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
-                    _logger->error("Failed to delete connection from epoll");
-                }
+    // Engine returns once acceptor and all connections are done. Every coroutine gets own stack, so
+    // switch costs the same however deep connection code is
+    Coroutine::Engine engine([this](Coroutine::Engine &e) { Unblock(e); }, kStackSize);
+    _engine = &engine;
+    _running = true;
+    engine.start(&ServerImpl::RunAcceptor, *this);
+    _engine = nullptr;
 
-                close(pc->_socket);
-                pc->OnClose();
+    for (Connection *pc : _connections) {
+        delete pc;
+    }
+    _connections.clear();
 
-                delete pc;
-            } else if (pc->_event.events != old_mask) {
-                if (epoll_ctl(epoll_descr, EPOLL_CTL_MOD, pc->_socket, &pc->_event)) {
-                    _logger->error("Failed to change connection event mask");
+    close(_epoll_descr);
+    _logger->warn("Acceptor stopped");
+}
 
-                    close(pc->_socket);
-                    pc->OnClose();
+void ServerImpl::OnAccept() {
+    _acceptor = _engine->current();
 
-                    delete pc;
-                }
-            }
-        }
+    struct epoll_event event;
+    event.events = EPOLLONESHOT;
+    event.data.ptr = _acceptor;
+    if (epoll_ctl(_epoll_descr, EPOLL_CTL_ADD, _server_socket, &event)) {
+        throw std::runtime_error("Failed to add file descriptor to epoll");
     }
-    _logger->warn("Acceptor stopped");
-}
 
-void ServerImpl::OnNewConnection(int epoll_descr) {
-    for (;;) {
+    while (_running) {
         struct sockaddr in_addr;
         socklen_t in_len;
 
@@ -191,11 +155,14 @@ void ServerImpl::OnNewConnection(int epoll_descr) {
         int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
         if (infd == -1) {
             if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-                break; // We have processed all incoming connections.
+                // We have processed all incoming connections, sleep until there are more
+                if (!Wait(_server_socket, event, EPOLLIN)) {
+                    break;
+                }
             } else {
                 _logger->error("Failed to accept socket");
-                break;
             }
+            continue;
         }
 
         // Print host and service info.
@@ -206,21 +173,131 @@ void ServerImpl::OnNewConnection(int epoll_descr) {
             _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
         }
 
-        // Register the new FD to be monitored by epoll.
-        Connection *pc = new (std::nothrow) Connection(infd);
-        if (pc == nullptr) {
-            throw std::runtime_error("Failed to allocate connection");
+        OnNewConnection(infd);
+    }
+
+    epoll_ctl(_epoll_descr, EPOLL_CTL_DEL, _server_socket, &event);
+    close(_server_socket);
+    _acceptor = nullptr;
+}
+
+void ServerImpl::OnNewConnection(int infd) {
+    Connection *pc = new (std::nothrow) Connection(infd, pStorage, _logger);
+    if (pc == nullptr) {
+        throw std::runtime_error("Failed to allocate connection");
+    }
+
+    // Coroutine gets control once acceptor blocks. Once it is scheduled connection belongs to it, so
+    // socket is registered in epoll by the coroutine itself
+    pc->_coroutine = _engine->run(&ServerImpl::RunConnection, *this, *pc);
+    if (pc->_coroutine == nullptr) {
+        _logger->error("Failed to start connection on descriptor {}", infd);
+        delete pc;
+        return;
+    }
+    _connections.insert(pc);
+}
+
+void ServerImpl::OnConnection(Connection &pc) {
+    _logger->debug("Start connection on descriptor {}", pc._socket);
+    LocalCounters().total_connections.Add();
+
+    pc._event.events = EPOLLONESHOT;
+    pc._event.data.ptr = pc._coroutine;
+    if (epoll_ctl(_epoll_descr, EPOLL_CTL_ADD, pc._socket, &pc._event)) {
+        _logger->error("Failed to start connection on descriptor {}", pc._socket);
+        pc._eof = true;
+    }
+
+    while (pc.isAlive()) {
+        // Read whatever client has sent and execute it
+        if (!pc._eof) {
+            ssize_t readed_bytes =
+                read(pc._socket, pc._read_buffer + pc._read_bytes, sizeof(pc._read_buffer) - pc._read_bytes);
+            if (readed_bytes > 0) {
+                _logger->debug("Got {} bytes from socket", readed_bytes);
+                LocalCounters().bytes_read.Add(readed_bytes);
+                pc._read_bytes += readed_bytes;
+                pc.Process();
+            } else if (readed_bytes == 0) {
+                _logger->debug("Connection closed");
+                pc._eof = true;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                _logger->error("Failed to read from descriptor {}: {}", pc._socket, strerror(errno));
+                break;
+            } else if (pc._output.Empty() && !Wait(pc._socket, pc._event, EPOLLIN)) {
+                break;
+            }
         }
 
-        // Register connection in worker's epoll
-        pc->Start();
-        if (pc->isAlive()) {
-            if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
-                pc->OnError();
-                delete pc;
+        // Send all the responses before reading more
+        if (!pc._output.Empty()) {
+            struct iovec iov[64];
+            ssize_t sent = writev(pc._socket, iov, pc._output.Fill(iov, 64));
+            if (sent > 0) {
+                LocalCounters().bytes_written.Add(sent);
+                pc._output.Consume(sent);
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                _logger->error("Failed to send response to descriptor {}: {}", pc._socket, strerror(errno));
+                break;
+            } else if (!Wait(pc._socket, pc._event, EPOLLOUT)) {
+                break;
             }
         }
     }
+
+    _logger->debug("Close connection on descriptor {}", pc._socket);
+    LocalCounters().closed_connections.Add();
+    epoll_ctl(_epoll_descr, EPOLL_CTL_DEL, pc._socket, &pc._event);
+    _connections.erase(&pc);
+    delete &pc;
+}
+
+bool ServerImpl::Wait(int fd, struct epoll_event &event, uint32_t events) {
+    if (!_running) {
+        return false;
+    }
+
+    event.events = events | EPOLLONESHOT;
+    if (epoll_ctl(_epoll_descr, EPOLL_CTL_MOD, fd, &event)) {
+        _logger->error("Failed to change descriptor {} event mask", fd);
+        return false;
+    }
+
+    _engine->block();
+    return _running;
+}
+
+void ServerImpl::Unblock(Coroutine::Engine &engine) {
+    // Everything is done, nobody to wait for
+    if (!_running) {
+        return;
+    }
+
+    // Engine finishes once unblocker returns having woken up nobody, so wait until there is someone
+    std::array<struct epoll_event, 64> mod_list;
+    int nmod;
+    while ((nmod = epoll_wait(_epoll_descr, &mod_list[0], mod_list.size(), -1)) <= 0) {
+        if (nmod == -1 && errno != EINTR) {
+            throw std::runtime_error("Failed to wait for events: " + std::string(strerror(errno)));
+        }
+    }
+    _logger->debug("Acceptor wokeup: {} events", nmod);
+
+    for (int i = 0; i < nmod; i++) {
+        if (mod_list[i].data.ptr != nullptr) {
+            engine.unblock(mod_list[i].data.ptr);
+            continue;
+        }
+
+        // Stop signal: everybody wakes up and finds out server is stopping
+        _logger->debug("Break acceptor due to stop signal");
+        _running = false;
+        engine.unblock(_acceptor);
+        for (Connection *pc : _connections) {
+            engine.unblock(pc->_coroutine);
+        }
+    }
 }
 
 } // namespace STcoroutine
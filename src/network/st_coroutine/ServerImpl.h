@@ -2,6 +2,7 @@
 #define AFINA_NETWORK_ST_COROUTINE_SERVER_H
 
 #include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include <afina/network/Server.h>
@@ -10,16 +11,23 @@ namespace spdlog {
 class logger;
 }
 
+struct epoll_event;
+
 namespace Afina {
+namespace Coroutine {
+class Engine;
+} // namespace Coroutine
 namespace Network {
 namespace STcoroutine {
 
-// Forward declaration, see Worker.h
-class Worker;
+// Forward declaration, see Connection.h
+class Connection;
 
 /**
  * # Network resource manager implementation
- * Epoll based server
+ * Epoll based server where acceptor and every connection are coroutines. Coroutine which can't
+ * proceed blocks itself until its descriptor is ready, once all of them are blocked engine calls
+ * epoll_wait and unblocks the ones got events.
  */
 class ServerImpl : public Server {
 public:
@@ -37,9 +45,27 @@ public:
 
 protected:
     void OnRun();
+    void OnAccept();
     void OnNewConnection(int);
+    void OnConnection(Connection &pc);
+
+    // Entry points of coroutines
+    static void RunAcceptor(ServerImpl &server) { server.OnAccept(); }
+    static void RunConnection(ServerImpl &server, Connection &pc) { server.OnConnection(pc); }
+
+    /**
+     * Blocks current coroutine until descriptor gets given events. Returns false if server is
+     * stopping and coroutine has to finish
+     */
+    bool Wait(int fd, struct epoll_event &event, uint32_t events);
+
+    // Called by engine once all coroutines are blocked
+    void Unblock(Coroutine::Engine &engine);
 
 private:
+    // Stack of every coroutine, guard page catches overflow
+    static const size_t kStackSize = 128 * 1024;
+
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
 
@@ -54,6 +80,17 @@ private:
     // Curstom event "device" used to wakeup workers
     int _event_fd;
 
+    // Everything below is accessed by IO thread only
+    int _epoll_descr;
+    Coroutine::Engine *_engine;
+    bool _running;
+
+    // Coroutine accepting new connections
+    void *_acceptor;
+
+    // Connections being served
+    std::unordered_set<Connection *> _connections;
+
     // IO thread
     std::thread _work_thread;
 };
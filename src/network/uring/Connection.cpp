@@ -0,0 +1,151 @@
+#include "Connection.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Counters.h>
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// See Connection.h
+Connection::~Connection() {
+    close(_socket);
+    LocalCounters().closed_connections.Add();
+}
+
+// See Connection.h
+void Connection::OnError() {
+    _logger->debug("Error on descriptor {}", _socket);
+    _alive = false;
+}
+
+// See Connection.h
+void Connection::OnClose() {
+    _logger->debug("Client closed descriptor {}", _socket);
+    _eof = true;
+    if (_output.Empty() && _sending.Empty()) {
+        _alive = false;
+    }
+}
+
+// See Connection.h
+void Connection::OnRecv(const char *data, size_t size) {
+    _logger->debug("Got {} bytes from socket", size);
+    LocalCounters().bytes_read.Add(size);
+    if (_eof) {
+        return;
+    }
+
+    // Usually command comes in a single piece, so it is executed right from the ring buffer
+    if (_input.empty()) {
+        size_t parsed = Process(data, size);
+        _input.append(data + parsed, size - parsed);
+    } else {
+        _input.append(data, size);
+        Execute();
+    }
+}
+
+// See Connection.h
+void Connection::OnSent(size_t size) {
+    LocalCounters().bytes_written.Add(size);
+    _sending.Consume(size);
+    if (_sending.Empty() && _output.Empty()) {
+        _queued = 0;
+
+        // Reading was paused, there could be commands left in the input
+        Execute();
+        if (_eof && _output.Empty()) {
+            _alive = false;
+        }
+    }
+}
+
+void Connection::Execute() {
+    size_t parsed = Process(_input.data(), _input.size());
+    _input.erase(0, parsed);
+}
+
+// Single block of data received from the socket could trigger inside actions a multiple times,
+// for example:
+// - recv#0: [<command1 start>]
+// - recv#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
+size_t Connection::Process(const char *data, size_t size) {
+    size_t pos = 0;
+    try {
+        while (pos < size && _queued < kMaxQueued) {
+            // There is no command yet
+            if (!_command) {
+                std::size_t parsed = 0;
+                if (_parser.Parse(data + pos, size - pos, parsed)) {
+                    _logger->debug("Found new command: {} in {} bytes", _parser.Name(), parsed);
+                    _command = _parser.Build(_arg_remains);
+                    if (_arg_remains > 0) {
+                        _arg_remains += 2;
+                    }
+                }
+
+                // Parsed might fails to consume any bytes from input stream, wait for more
+                if (parsed == 0) {
+                    break;
+                }
+                pos += parsed;
+            }
+
+            // There is command, but we still wait for argument to arrive...
+            if (_command && _arg_remains > 0) {
+                std::size_t to_read = std::min(_arg_remains, size - pos);
+                _argument.append(data + pos, to_read);
+                pos += to_read;
+                _arg_remains -= to_read;
+            }
+
+            // Thre is command & argument - RUN!
+            if (_command && _arg_remains == 0) {
+                if (_argument.size()) {
+                    _argument.resize(_argument.size() - 2);
+                }
+                _command->Execute(*_pStorage, _argument, _output);
+                _output.Append("\r\n");
+                _queued++;
+
+                // Prepare for the next command
+                _command = nullptr;
+                _argument.resize(0);
+                _parser.Reset();
+            }
+        }
+    } catch (std::runtime_error &ex) {
+        // Stream position is lost, so report error and close connection once it is sent
+        _logger->error("Failed to process command on descriptor {}: {}", _socket, ex.what());
+        _output.Append("CLIENT_ERROR " + std::string(ex.what()) + "\r\n");
+        _eof = true;
+        _input.clear();
+        return size;
+    }
+    return pos;
+}
+
+bool Connection::PrepareSend() {
+    if (_sending.Empty()) {
+        if (_output.Empty()) {
+            return false;
+        }
+        std::swap(_sending, _output);
+    }
+
+    _msg.msg_iovlen = _sending.Fill(_iov, kMaxIov);
+    return true;
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,118 @@
+#ifndef AFINA_NETWORK_URING_CONNECTION_H
+#define AFINA_NETWORK_URING_CONNECTION_H
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+
+#include "protocol/Parser.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
+namespace Network {
+namespace Uring {
+
+/**
+ * # Client connection served by the ring
+ * Connection has at most one recv and one send request in the ring. Recv is multishot and keeps
+ * delivering data until it is cancelled, send takes all the responses accumulated so far.
+ *
+ * Responses executed while send is in flight are collected in the separate queue, because kernel
+ * reads the one being sent and it must not change until send completes.
+ */
+class Connection {
+public:
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl)
+        : _socket(s), _pStorage(ps), _logger(pl), _alive(true), _eof(false), _recv_armed(false),
+          _recv_cancelled(false), _send_armed(false), _command(nullptr), _arg_remains(0), _queued(0) {
+        std::memset(&_msg, 0, sizeof(_msg));
+        _msg.msg_iov = _iov;
+    }
+    ~Connection();
+
+    inline bool isAlive() const { return _alive; }
+
+protected:
+    void OnError();
+    void OnClose();
+    void OnRecv(const char *data, size_t size);
+    void OnSent(size_t size);
+
+private:
+    friend class ServerImpl;
+
+    // Max number of responses waiting to be sent before connection stops reading
+    static const size_t kMaxQueued = 128;
+
+    // Max number of received bytes waiting to be parsed before connection stops reading
+    static const size_t kMaxInput = 16384;
+
+    // Max number of chunks passed to a single send
+    static const size_t kMaxIov = 64;
+
+    // Executes commands which are complete in the input
+    void Execute();
+
+    // Executes complete commands in the given data until output queue is full, returns number of
+    // bytes consumed
+    size_t Process(const char *data, size_t size);
+
+    // Prepares message with the responses to be sent, returns false if there are none
+    bool PrepareSend();
+
+    // Connection wants more data from the client
+    inline bool WantsRecv() const { return _alive && !_eof && _queued < kMaxQueued && _input.size() < kMaxInput; }
+
+    int _socket;
+
+    std::shared_ptr<Afina::Storage> _pStorage;
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Connection must be destroyed once ring is done with it
+    bool _alive;
+
+    // Nothing more is going to be read, connection is closed once output is sent
+    bool _eof;
+
+    // Requests in the ring
+    bool _recv_armed;
+    bool _recv_cancelled;
+    bool _send_armed;
+
+    // Bytes received but not parsed yet
+    std::string _input;
+
+    // Command being parsed and its argument, command object is owned and reused by the parser
+    Protocol::Parser _parser;
+    Execute::Command *_command;
+    std::size_t _arg_remains;
+    std::string _argument;
+
+    // Responses which are not sent yet, and the ones being sent by the ring
+    Execute::Response _output;
+    Execute::Response _sending;
+    size_t _queued;
+
+    // Message of the send in flight
+    struct msghdr _msg;
+    struct iovec _iov[kMaxIov];
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_CONNECTION_H
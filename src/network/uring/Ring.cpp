@@ -0,0 +1,262 @@
+#include "Ring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+namespace {
+
+inline unsigned LoadAcquire(const unsigned *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+
+inline void StoreRelease(unsigned *p, unsigned v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+inline void *Map(size_t size, int fd, off_t offset) {
+    void *result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    if (result == MAP_FAILED) {
+        throw std::runtime_error("Failed to map io_uring: " + std::string(strerror(errno)));
+    }
+    return result;
+}
+
+} // namespace
+
+// See Ring.h
+Ring::Ring(unsigned entries, unsigned buffers, unsigned buffer_size)
+    : _fd(-1), _sq_ptr(MAP_FAILED), _cq_ptr(MAP_FAILED), _sqes(static_cast<io_uring_sqe *>(MAP_FAILED)),
+      _buf_ring(static_cast<io_uring_buf_ring *>(MAP_FAILED)), _buffers(static_cast<char *>(MAP_FAILED)),
+      _buffers_count(buffers), _buffer_size(buffer_size) {
+    if (buffers == 0 || (buffers & (buffers - 1)) != 0 || buffers > 32768) {
+        throw std::invalid_argument("Number of buffers must be a power of two up to 32768");
+    }
+
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * 2;
+
+    _fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (_fd == -1) {
+        throw std::runtime_error("Failed to setup io_uring: " + std::string(strerror(errno)));
+    }
+
+    try {
+        _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            _sq_size = _cq_size = std::max(_sq_size, _cq_size);
+        }
+
+        _sq_ptr = Map(_sq_size, _fd, IORING_OFF_SQ_RING);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            _cq_ptr = _sq_ptr;
+        } else {
+            _cq_ptr = Map(_cq_size, _fd, IORING_OFF_CQ_RING);
+        }
+        _sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        _sqes = static_cast<io_uring_sqe *>(Map(_sqes_size, _fd, IORING_OFF_SQES));
+
+        char *sq = static_cast<char *>(_sq_ptr);
+        _sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        _sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        _sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        _sq_entries = params.sq_entries;
+        _sq_local_tail = *_sq_tail;
+
+        // Entries are always taken in order, so index array maps every slot to itself
+        unsigned *array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        for (unsigned i = 0; i < _sq_entries; i++) {
+            array[i] = i;
+        }
+
+        char *cq = static_cast<char *>(_cq_ptr);
+        _cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        _cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        _cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+        // Buffer ring must be page aligned, so it gets own mapping
+        _buf_ring_size = buffers * sizeof(struct io_uring_buf);
+        _buf_ring = static_cast<io_uring_buf_ring *>(
+            mmap(nullptr, _buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (_buf_ring == MAP_FAILED) {
+            throw std::runtime_error("Failed to allocate buffer ring: " + std::string(strerror(errno)));
+        }
+
+        _buffers = static_cast<char *>(
+            mmap(nullptr, size_t(buffers) * buffer_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (_buffers == MAP_FAILED) {
+            throw std::runtime_error("Failed to allocate buffers: " + std::string(strerror(errno)));
+        }
+
+        // Kernel pins pages of the ring on register, they must not be shared zero page by then
+        std::memset(_buf_ring, 0, _buf_ring_size);
+
+        struct io_uring_buf_reg reg;
+        std::memset(&reg, 0, sizeof(reg));
+        reg.ring_addr = reinterpret_cast<uint64_t>(_buf_ring);
+        reg.ring_entries = buffers;
+        reg.bgid = kBufferGroup;
+        if (syscall(__NR_io_uring_register, _fd, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+            throw std::runtime_error("Failed to register buffer ring: " + std::string(strerror(errno)));
+        }
+
+        for (unsigned i = 0; i < buffers; i++) {
+            Recycle(i);
+        }
+    } catch (...) {
+        Destroy();
+        throw;
+    }
+}
+
+// See Ring.h
+Ring::~Ring() { Destroy(); }
+
+// See Ring.h
+void Ring::Accept(int socket, uint64_t data) {
+    struct io_uring_sqe *sqe = Sqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = socket;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = data;
+}
+
+// See Ring.h
+void Ring::Recv(int socket, uint64_t data) {
+    struct io_uring_sqe *sqe = Sqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = socket;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = data;
+}
+
+// See Ring.h
+void Ring::SendMsg(int socket, const struct msghdr *msg, uint64_t data) {
+    struct io_uring_sqe *sqe = Sqe();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = socket;
+    sqe->addr = reinterpret_cast<uint64_t>(msg);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = data;
+}
+
+// See Ring.h
+void Ring::Read(int fd, void *buf, size_t size, uint64_t data) {
+    struct io_uring_sqe *sqe = Sqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = size;
+    sqe->user_data = data;
+}
+
+// See Ring.h
+void Ring::Cancel(uint64_t target, uint64_t data) {
+    struct io_uring_sqe *sqe = Sqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = target;
+    sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+    sqe->user_data = data;
+}
+
+// See Ring.h
+void Ring::Submit(unsigned wait_nr) {
+    StoreRelease(_sq_tail, _sq_local_tail);
+    unsigned to_submit = _sq_local_tail - LoadAcquire(_sq_head);
+    unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    while (syscall(__NR_io_uring_enter, _fd, to_submit, wait_nr, flags, nullptr, 0) == -1) {
+        if (errno == EBUSY || errno == EAGAIN) {
+            // Completion queue is full, caller must reap it first
+            return;
+        } else if (errno != EINTR) {
+            throw std::runtime_error("Failed to submit to io_uring: " + std::string(strerror(errno)));
+        }
+    }
+}
+
+// See Ring.h
+const struct io_uring_cqe *Ring::Peek() {
+    unsigned head = *_cq_head;
+    if (head == LoadAcquire(_cq_tail)) {
+        return nullptr;
+    }
+    return &_cqes[head & _cq_mask];
+}
+
+// See Ring.h
+void Ring::Pop() { StoreRelease(_cq_head, *_cq_head + 1); }
+
+// See Ring.h
+const char *Ring::Buffer(uint32_t flags, uint16_t &id) const {
+    if ((flags & IORING_CQE_F_BUFFER) == 0) {
+        return nullptr;
+    }
+    id = flags >> IORING_CQE_BUFFER_SHIFT;
+    return _buffers + size_t(id) * _buffer_size;
+}
+
+// See Ring.h
+void Ring::Recycle(uint16_t id) {
+    unsigned short tail = _buf_ring->tail;
+    // Flexible array of the header has extra padding in C++, so entries are addressed directly
+    struct io_uring_buf &buf = reinterpret_cast<io_uring_buf *>(_buf_ring)[tail & (_buffers_count - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(_buffers + size_t(id) * _buffer_size);
+    buf.len = _buffer_size;
+    buf.bid = id;
+    __atomic_store_n(&_buf_ring->tail, static_cast<unsigned short>(tail + 1), __ATOMIC_RELEASE);
+}
+
+struct io_uring_sqe *Ring::Sqe() {
+    if (_sq_local_tail - LoadAcquire(_sq_head) == _sq_entries) {
+        Submit(0);
+        if (_sq_local_tail - LoadAcquire(_sq_head) == _sq_entries) {
+            throw std::runtime_error("io_uring submission queue overflow");
+        }
+    }
+
+    struct io_uring_sqe *sqe = &_sqes[_sq_local_tail & _sq_mask];
+    std::memset(sqe, 0, sizeof(*sqe));
+    _sq_local_tail++;
+    return sqe;
+}
+
+void Ring::Destroy() {
+    // Kernel stops using buffers once ring is closed
+    if (_fd != -1) {
+        close(_fd);
+    }
+    if (_buffers != MAP_FAILED) {
+        munmap(_buffers, size_t(_buffers_count) * _buffer_size);
+    }
+    if (_buf_ring != MAP_FAILED) {
+        munmap(_buf_ring, _buf_ring_size);
+    }
+    if (_sqes != MAP_FAILED) {
+        munmap(_sqes, _sqes_size);
+    }
+    if (_cq_ptr != MAP_FAILED && _cq_ptr != _sq_ptr) {
+        munmap(_cq_ptr, _cq_size);
+    }
+    if (_sq_ptr != MAP_FAILED) {
+        munmap(_sq_ptr, _sq_size);
+    }
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
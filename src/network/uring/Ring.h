@@ -0,0 +1,113 @@
+#ifndef AFINA_NETWORK_URING_RING_H
+#define AFINA_NETWORK_URING_RING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+/**
+ * # Minimal io_uring instance
+ * Talks to the kernel by raw syscalls, so no liburing is needed. Submission queue entries are
+ * only prepared by the methods below, nothing reaches the kernel until Submit is called. That way
+ * all the requests made while processing a batch of completions go in a single syscall.
+ *
+ * Ring also owns a provided buffers ring: recv requests pick buffers from it by themselves, and
+ * completion tells which one was used. Buffer must be given back by Recycle once data is consumed.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class Ring {
+public:
+    /**
+     * Creates ring with the given number of submission entries and completion queue twice as
+     * large, throws std::runtime_error if kernel doesn't support it
+     */
+    Ring(unsigned entries, unsigned buffers, unsigned buffer_size);
+    ~Ring();
+
+    // Requests. Completion carries given user data
+    void Accept(int socket, uint64_t data);
+    void Recv(int socket, uint64_t data);
+    void SendMsg(int socket, const struct msghdr *msg, uint64_t data);
+    void Read(int fd, void *buf, size_t size, uint64_t data);
+
+    /**
+     * Cancels request with the given user data, cancellation itself reports only failures
+     */
+    void Cancel(uint64_t target, uint64_t data);
+
+    /**
+     * Passes all prepared requests to the kernel and waits until at least wait_nr of them complete
+     */
+    void Submit(unsigned wait_nr);
+
+    /**
+     * Returns the oldest completion or nullptr if there is none. Completion stays valid until Pop
+     */
+    const struct io_uring_cqe *Peek();
+    void Pop();
+
+    /**
+     * Buffer picked by the completed recv and its id, nullptr if none was used. Takes flags of the
+     * completion
+     */
+    const char *Buffer(uint32_t flags, uint16_t &id) const;
+
+    /**
+     * Returns buffer back to the kernel
+     */
+    void Recycle(uint16_t id);
+
+private:
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+
+    // Next free submission entry, pending ones are submitted if queue is full
+    struct io_uring_sqe *Sqe();
+
+    void Destroy();
+
+    static const uint16_t kBufferGroup = 0;
+
+    int _fd;
+
+    // Mapped rings
+    void *_sq_ptr;
+    size_t _sq_size;
+    void *_cq_ptr;
+    size_t _cq_size;
+    struct io_uring_sqe *_sqes;
+    size_t _sqes_size;
+
+    // Submission queue
+    unsigned *_sq_head;
+    unsigned *_sq_tail;
+    unsigned _sq_mask;
+    unsigned _sq_entries;
+    unsigned _sq_local_tail;
+
+    // Completion queue
+    unsigned *_cq_head;
+    unsigned *_cq_tail;
+    unsigned _cq_mask;
+    struct io_uring_cqe *_cqes;
+
+    // Provided buffers
+    struct io_uring_buf_ring *_buf_ring;
+    size_t _buf_ring_size;
+    char *_buffers;
+    unsigned _buffers_count;
+    unsigned _buffer_size;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_RING_H
@@ -0,0 +1,228 @@
+#include "ServerImpl.h"
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Counters.h>
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+
+#include "Connection.h"
+#include "Ring.h"
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// See Server.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _server_socket(-1), _event_fd(-1), _event_value(0) {}
+
+// See Server.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start uring network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    // 256 requests per submission, 1024 buffers of 4K to receive into
+    _ring.reset(new Ring(256, 1024, 4096));
+
+    // Create server socket, ring waits for connections by itself so it is left blocking
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    _server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(_server_socket, SOMAXCONN) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _event_fd = eventfd(0, 0);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create event file descriptor: " + std::string(strerror(errno)));
+    }
+
+    _work_thread = std::thread(&ServerImpl::OnRun, this);
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+
+    // Wakeup ring waiting for completions
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup workers");
+    }
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    // Wait for work to be complete
+    _work_thread.join();
+}
+
+// See ServerImpl.h
+void ServerImpl::OnRun() {
+    _logger->info("Start ring loop");
+    _ring->Accept(_server_socket, kAccept);
+    _ring->Read(_event_fd, &_event_value, sizeof(_event_value), kWakeup);
+
+    bool run = true;
+    while (run) {
+        // Everything requested during previous batch goes to the kernel along with the wait
+        _ring->Submit(1);
+
+        const struct io_uring_cqe *cqe;
+        while ((cqe = _ring->Peek()) != nullptr) {
+            Connection *pc = reinterpret_cast<Connection *>(cqe->user_data & ~kOpMask);
+            uint64_t op = cqe->user_data & kOpMask;
+            if (pc != nullptr) {
+                OnConnectionEvent(pc, op, cqe->res, cqe->flags);
+            } else if (op == kWakeup) {
+                _logger->debug("Break loop due to stop signal");
+                run = false;
+            } else if (op == kAccept) {
+                if (cqe->res >= 0) {
+                    OnNewConnection(cqe->res);
+                } else {
+                    _logger->error("Failed to accept socket: {}", strerror(-cqe->res));
+                }
+
+                // Multishot accept could be terminated by the kernel, start it over
+                if ((cqe->flags & IORING_CQE_F_MORE) == 0 && run) {
+                    _ring->Accept(_server_socket, kAccept);
+                }
+            } else if (op == kCancel) {
+                _logger->debug("Cancel failed: {}", strerror(-cqe->res));
+            }
+            _ring->Pop();
+        }
+    }
+
+    // Kernel must be done with the connections before they are destroyed
+    _ring.reset();
+    for (Connection *pc : _connections) {
+        delete pc;
+    }
+    _connections.clear();
+
+    close(_server_socket);
+    close(_event_fd);
+    _logger->warn("Ring loop stopped");
+}
+
+void ServerImpl::OnNewConnection(int socket) {
+    _logger->debug("Accepted connection on descriptor {}", socket);
+
+    Connection *pc = new (std::nothrow) Connection(socket, pStorage, _logger);
+    if (pc == nullptr) {
+        close(socket);
+        throw std::runtime_error("Failed to allocate connection");
+    }
+
+    LocalCounters().total_connections.Add();
+    _connections.insert(pc);
+    Update(pc);
+}
+
+void ServerImpl::OnConnectionEvent(Connection *pc, uint64_t op, int res, uint32_t flags) {
+    if (op == kRecv) {
+        uint16_t buffer_id;
+        const char *buffer = _ring->Buffer(flags, buffer_id);
+        if (res > 0) {
+            pc->OnRecv(buffer, res);
+        } else if (res == 0) {
+            pc->OnClose();
+        } else if (res == -ENOBUFS) {
+            // All buffers were taken, they are given back as soon as the batch is processed
+            _logger->debug("No buffers to receive on descriptor {}", pc->_socket);
+        } else if (res != -ECANCELED) {
+            pc->OnError();
+        }
+
+        // Data is either executed or copied to the connection, buffer could be reused
+        if (buffer != nullptr) {
+            _ring->Recycle(buffer_id);
+        }
+        if ((flags & IORING_CQE_F_MORE) == 0) {
+            pc->_recv_armed = false;
+            pc->_recv_cancelled = false;
+        }
+    } else if (op == kSend) {
+        pc->_send_armed = false;
+        if (res >= 0) {
+            pc->OnSent(res);
+        } else {
+            pc->OnError();
+        }
+    }
+
+    Update(pc);
+}
+
+void ServerImpl::Update(Connection *pc) {
+    if (pc->isAlive() && !pc->_send_armed && pc->PrepareSend()) {
+        _ring->SendMsg(pc->_socket, &pc->_msg, reinterpret_cast<uint64_t>(pc) | kSend);
+        pc->_send_armed = true;
+    }
+
+    if (pc->WantsRecv()) {
+        if (!pc->_recv_armed) {
+            _ring->Recv(pc->_socket, reinterpret_cast<uint64_t>(pc) | kRecv);
+            pc->_recv_armed = true;
+        }
+    } else if (pc->_recv_armed && !pc->_recv_cancelled) {
+        _ring->Cancel(reinterpret_cast<uint64_t>(pc) | kRecv, kCancel);
+        pc->_recv_cancelled = true;
+    }
+
+    // Connection could be destroyed only once ring has no requests referring to it
+    if (!pc->isAlive() && !pc->_recv_armed && !pc->_send_armed) {
+        _logger->debug("Close connection on descriptor {}", pc->_socket);
+        _connections.erase(pc);
+        delete pc;
+    }
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
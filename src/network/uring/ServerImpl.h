@@ -0,0 +1,87 @@
+#ifndef AFINA_NETWORK_URING_SERVER_H
+#define AFINA_NETWORK_URING_SERVER_H
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// Forward declaration, see Connection.h
+class Connection;
+
+// Forward declaration, see Ring.h
+class Ring;
+
+/**
+ * # Network resource manager implementation
+ * io_uring based server: connections are accepted by multishot accept, data is received by
+ * multishot recv into buffers provided by the ring and responses are sent by sendmsg. All the
+ * requests made while processing completions are submitted together with waiting for the next
+ * ones, so loop makes a single syscall per batch of events.
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ~ServerImpl();
+
+    // See Server.h
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+protected:
+    void OnRun();
+    void OnNewConnection(int socket);
+    void OnConnectionEvent(Connection *pc, uint64_t op, int res, uint32_t flags);
+
+    // Makes requests connection needs and destroys it once it is done
+    void Update(Connection *pc);
+
+private:
+    // Ring requests: connection pointer with the operation in the low bits, or just the
+    // operation for requests of the server itself
+    static const uint64_t kOpMask = 3;
+    static const uint64_t kAccept = 1;
+    static const uint64_t kWakeup = 2;
+    static const uint64_t kCancel = 3;
+    static const uint64_t kRecv = 1;
+    static const uint64_t kSend = 2;
+
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Socket to accept new connection on
+    int _server_socket;
+
+    // Curstom event "device" used to wakeup the loop
+    int _event_fd;
+    uint64_t _event_value;
+
+    std::unique_ptr<Ring> _ring;
+
+    // Connections alive
+    std::unordered_set<Connection *> _connections;
+
+    // IO thread
+    std::thread _work_thread;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_SERVER_H
@@ -1,13 +1,22 @@
 #include "Parser.h"
 
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <afina/execute/Add.h>
 #include <afina/execute/Append.h>
 #include <afina/execute/Command.h>
 #include <afina/execute/Delete.h>
+#include <afina/execute/FlushAll.h>
 #include <afina/execute/Get.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
@@ -15,11 +24,263 @@
 namespace Afina {
 namespace Protocol {
 
+namespace {
+
+/**
+ * Command line split by spaces, tokens point right into the input
+ */
+struct line {
+    // Multi get with more keys than that goes through the state machine
+    static const size_t kMaxTokens = 64;
+
+    const char *token[kMaxTokens];
+    size_t length[kMaxTokens];
+    size_t count = 0;
+
+    // Token starts right after the previous separator, empty ones are left to the state machine
+    bool Add(const char *start, const char *end) {
+        if (start == end || count == kMaxTokens) {
+            return false;
+        }
+        token[count] = start;
+        length[count] = end - start;
+        count++;
+        return true;
+    }
+};
+
+#if defined(__AVX2__)
+const size_t kChunk = 32;
+
+// Bit masks of spaces and carriage returns among kChunk bytes starting at p
+inline uint32_t Separators(const char *p, uint32_t &cr) {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    cr = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+    return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' '))));
+}
+#elif defined(__SSE2__)
+const size_t kChunk = 16;
+
+// Bit masks of spaces and carriage returns among kChunk bytes starting at p
+inline uint32_t Separators(const char *p, uint32_t &cr) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    cr = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+    return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' '))));
+}
+#endif
+
+/**
+ * Splits command line terminated by \r\n into tokens, returns its size including terminator or 0
+ * if there is no complete line in the input or it can't be split
+ */
+size_t Split(const char *input, size_t size, line &result) {
+    const char *start = input;
+    size_t pos = 0;
+    size_t cr = size;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    for (; pos + kChunk <= size && cr == size; pos += kChunk) {
+        uint32_t crs;
+        uint32_t spaces = Separators(input + pos, crs);
+        if (crs != 0) {
+            cr = pos + __builtin_ctz(crs);
+            spaces &= (crs & -crs) - 1;
+        }
+
+        for (; spaces != 0; spaces &= spaces - 1) {
+            const char *end = input + pos + __builtin_ctz(spaces);
+            if (!result.Add(start, end)) {
+                return 0;
+            }
+            start = end + 1;
+        }
+    }
+#endif
+
+    // Tail shorter than a chunk
+    for (; pos < size && cr == size; pos++) {
+        if (input[pos] == '\r') {
+            cr = pos;
+        } else if (input[pos] == ' ') {
+            if (!result.Add(start, input + pos)) {
+                return 0;
+            }
+            start = input + pos + 1;
+        }
+    }
+
+    if (cr + 1 >= size || input[cr + 1] != '\n' || !result.Add(start, input + cr)) {
+        return 0;
+    }
+    return cr + 2;
+}
+
+/**
+ * Parses up to 9 decimal digits, so that value never overflows. Longer numbers are left to the
+ * state machine, which reports overflow
+ */
+inline bool ParseNumber(const char *p, size_t length, uint32_t &value) {
+    if (length > 9) {
+        return false;
+    }
+
+    value = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (p[i] < '0' || p[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (p[i] - '0');
+    }
+    return true;
+}
+
+/**
+ * Perfect hash of the known command names: no two of them land in the same slot, so lookup takes
+ * a single comparison instead of a chain of them
+ */
+struct command_name {
+    const char *name;
+    size_t length;
+    uint8_t command;
+};
+
+inline size_t NameSlot(const char *name, size_t length) {
+    return (length * 3 + uint8_t(name[0]) + uint8_t(name[length - 1])) & 15;
+}
+
+} // namespace
+
+// See Parse.h
+bool Parser::ParseLine(const char *input, const size_t size, size_t &parsed) {
+    line tokens;
+    size_t line_size = Split(input, size, tokens);
+    if (line_size == 0) {
+        return false;
+    }
+
+    const char *name_start = tokens.token[0];
+    size_t name_size = tokens.length[0];
+    Command found = Lookup(name_start, name_size);
+
+    switch (found) {
+    case Command::cSet:
+    case Command::cAdd:
+    case Command::cAppend:
+    case Command::cPrepend: {
+        // <command name> <key> <flags> <exptime> <bytes>, noreply goes through the state machine
+        if (tokens.count != 5) {
+            return false;
+        }
+
+        uint32_t f, e, b;
+        bool minus = tokens.length[3] > 1 && tokens.token[3][0] == '-';
+        if (!ParseNumber(tokens.token[2], tokens.length[2], f) ||
+            !ParseNumber(tokens.token[3] + minus, tokens.length[3] - minus, e) ||
+            !ParseNumber(tokens.token[4], tokens.length[4], b)) {
+            return false;
+        }
+
+        keys.Add(tokens.token[1], tokens.length[1]);
+        flags = f;
+        exprtime = minus ? -int32_t(e) : int32_t(e);
+        bytes = b;
+        break;
+    }
+
+    case Command::cGet:
+    case Command::cGets: {
+        if (tokens.count < 2) {
+            return false;
+        }
+
+        // Keys are copied straight from the input, without a string for every one of them
+        for (size_t i = 1; i < tokens.count; i++) {
+            keys.Add(tokens.token[i], tokens.length[i]);
+        }
+        break;
+    }
+
+    case Command::cStats:
+    case Command::cFlushAll: {
+        if (tokens.count != 1) {
+            return false;
+        }
+        break;
+    }
+
+    default:
+        return false;
+    }
+
+    name.assign(name_start, name_size);
+    command = found;
+    state = State::sLF;
+    parse_complete = true;
+    parsed = line_size;
+    return true;
+}
+
+/**
+ * One object per command type, they are filled in by Build
+ */
+struct Parser::commands {
+    Execute::Set set;
+    Execute::Add add;
+    Execute::Append append;
+    Execute::Get get;
+    Execute::Stats stats;
+    Execute::FlushAll flush_all;
+};
+
+// See Parse.h
+Parser::Parser() : pool(new commands()) { Reset(); }
+
+// See Parse.h
+Parser::~Parser() {}
+
+// See Parse.h
+Parser::Command Parser::Lookup(const char *name, size_t length) {
+    // Every name is placed at its NameSlot
+    static const command_name table[16] = {
+        {"set", 3, cSet},
+        {nullptr, 0, cUnknown},
+        {nullptr, 0, cUnknown},
+        {nullptr, 0, cUnknown},
+        {"get", 3, cGet},
+        {"stats", 5, cStats},
+        {"gets", 4, cGets},
+        {"append", 6, cAppend},
+        {nullptr, 0, cUnknown},
+        {"prepend", 7, cPrepend},
+        {nullptr, 0, cUnknown},
+        {nullptr, 0, cUnknown},
+        {nullptr, 0, cUnknown},
+        {"flush_all", 9, cFlushAll},
+        {"add", 3, cAdd},
+        {nullptr, 0, cUnknown},
+    };
+
+    if (length == 0) {
+        return cUnknown;
+    }
+
+    const command_name &slot = table[NameSlot(name, length)];
+    if (slot.length != length || std::memcmp(slot.name, name, length) != 0) {
+        return cUnknown;
+    }
+    return Command(slot.command);
+}
+
 // See Parse.h
 bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
     size_t pos;
     parsed = 0;
 
+    // Usually the whole command line is in the buffer already
+    if (state == State::sName && name.empty() && ParseLine(input, size, parsed)) {
+        return true;
+    }
+
     for (pos = 0; pos < size && !parse_complete; pos++) {
         char c = input[pos];
         // std::cout << "[" << pos << "] '" << c << "': state=" << int(state) << std::endl;
@@ -28,11 +289,12 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
         case State::sName: {
             if (c == ' ' || c == '\r') {
                 // std::cout << "parser debug: name='" << name << "'" << std::endl;
-                if (name == "set" || name == "add" || name == "append" || name == "prepend") {
+                command = Lookup(name.data(), name.size());
+                if (command == cSet || command == cAdd || command == cAppend || command == cPrepend) {
                     state = State::spKey;
-                } else if (name == "get" || name == "gets") {
+                } else if (command == cGet || command == cGets) {
                     state = State::sgKey;
-                } else if (name == "stats") {
+                } else if (command == cStats || command == cFlushAll) {
                     state = State::sLF;
                     continue;
                 } else {
@@ -47,8 +309,8 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
         case State::spKey: {
             if (c == ' ') {
                 state = State::spFlags;
-                keys.push_back(curKey);
-                // std::cout << "parser debug: key[" << keys.size() - 1 << "]='" << curKey << "'" << std::endl;
+                keys.Add(curKey);
+                // std::cout << "parser debug: key[" << keys.Size() - 1 << "]='" << curKey << "'" << std::endl;
             } else {
                 curKey.push_back(c);
             }
@@ -57,19 +319,19 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
 
         case State::sgKey: {
             if (c == '\r') {
-                keys.push_back(curKey);
-                // std::cout << "parser debug: total '" << keys.size() << " keys" << std::endl;
+                keys.Add(curKey);
+                // std::cout << "parser debug: total '" << keys.Size() << " keys" << std::endl;
 
-                if (keys.size() == 0) {
+                if (keys.Size() == 0) {
                     throw std::runtime_error("Client provides no key to retrive");
                 }
 
                 curKey.clear();
                 state = State::sLF;
             } else if (c == ' ') {
-                // std::cout << "parser debug: key[" << keys.size() << "]='" << curKey << "'" << std::endl;
+                // std::cout << "parser debug: key[" << keys.Size() << "]='" << curKey << "'" << std::endl;
                 state = State::sgKey;
-                keys.push_back(curKey);
+                keys.Add(curKey);
                 curKey.clear();
             } else {
                 curKey.push_back(c);
@@ -109,17 +371,9 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 state = State::spBytes;
                 // std::cout << "parser debug: ExprTime='" << exprtime << "'" << std::endl;
             } else if (c >= '0' && c <= '9') {
-                int32_t et = exprtime;
-                if (negative) {
-                    et -= (c - '0');
-                    if (et > exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
-                } else {
-                    et += (c - '0');
-                    if (et < exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
+                int64_t et = int64_t(exprtime) * 10 + (negative ? -(c - '0') : (c - '0'));
+                if (et > std::numeric_limits<int32_t>::max() || et < std::numeric_limits<int32_t>::min()) {
+                    throw std::runtime_error("Expire time field overflow");
                 }
                 exprtime = et;
             }
@@ -162,23 +416,30 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
 }
 
 // See Parse.h
-std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) const {
+Execute::Command *Parser::Build(size_t &body_size) {
     if (state != State::sLF) {
-        return std::unique_ptr<Execute::Command>(nullptr);
+        return nullptr;
     }
 
     body_size = bytes;
-    if (name == "set") {
-        return std::unique_ptr<Execute::Command>(new Execute::Set(keys[0], flags, exprtime));
-    } else if (name == "add") {
-        return std::unique_ptr<Execute::Command>(new Execute::Add(keys[0], flags, exprtime));
-    } else if (name == "append") {
-        return std::unique_ptr<Execute::Command>(new Execute::Append(keys[0], flags, exprtime));
-    } else if (name == "get") {
-        return std::unique_ptr<Execute::Command>(new Execute::Get(keys));
-    } else if (name == "stats") {
-        return std::unique_ptr<Execute::Command>(new Execute::Stats());
-    } else {
+    switch (command) {
+    case cSet:
+        pool->set.Assign(keys[0].data, keys[0].size, flags, exprtime);
+        return &pool->set;
+    case cAdd:
+        pool->add.Assign(keys[0].data, keys[0].size, flags, exprtime);
+        return &pool->add;
+    case cAppend:
+        pool->append.Assign(keys[0].data, keys[0].size, flags, exprtime);
+        return &pool->append;
+    case cGet:
+        pool->get.Assign(keys);
+        return &pool->get;
+    case cStats:
+        return &pool->stats;
+    case cFlushAll:
+        return &pool->flush_all;
+    default:
         throw std::runtime_error("Unsupported command");
     }
 }
@@ -186,8 +447,9 @@ std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) const {
 // See Parse.h
 void Parser::Reset() {
     state = State::sName;
+    command = cUnknown;
     name.clear();
-    keys.clear();
+    keys.Clear();
     curKey.clear();
     parse_complete = false;
     flags = 0;
@@ -3,11 +3,12 @@
 
 #include <memory>
 #include <string>
-#include <vector>
 
 #include <cstddef>
 #include <cstdint>
 
+#include <afina/execute/Keys.h>
+
 namespace Afina {
 namespace Execute {
 class Command;
@@ -20,7 +21,8 @@ namespace Protocol {
  */
 class Parser {
 public:
-    Parser() { Reset(); }
+    Parser();
+    ~Parser();
     /**
      * Push given string into parser input. Method returns true if it was a command parsed out
      * from comulative input. In a such case method Build will return new command
@@ -45,8 +47,11 @@ public:
     /**
      * Builds new command from parsed input. In case if it wasn't enough input to prse command out
      * method return nullptr
+     *
+     * Command belongs to the parser: there is a single object of every type, which is filled in
+     * again by each Build instead of being allocated, so it is valid until the next Build only
      */
-    std::unique_ptr<Execute::Command> Build(size_t &body_size) const;
+    Execute::Command *Build(size_t &body_size);
 
     /**
      * Reset parse so that it could be used to parse out new command
@@ -64,12 +69,30 @@ private:
      */
     enum State : uint16_t { sCR, sLF, sName, spKey, spFlags, spExprTimeStart, spExprTime, spBytes, sgKey };
 
+    /**
+     * Commands known to the parser, name is looked up once it is complete
+     */
+    enum Command : uint8_t { cUnknown, cSet, cAdd, cAppend, cPrepend, cGet, cGets, cStats, cFlushAll };
+
+    /**
+     * Fast path: parses command line which is in the input completely. Returns false without any
+     * changes to the parser if line isn't complete yet or has something unusual in it, then the
+     * input goes through the state machine
+     */
+    bool ParseLine(const char *input, const size_t size, size_t &parsed);
+
+    /**
+     * Command of the given name, cUnknown if there is no such one
+     */
+    static Command Lookup(const char *name, size_t length);
+
     // Current parser state
     State state;
+    Command command;
 
-    // vrious fields of the command
+    // vrious fields of the command, keys memory is reused by the next command after Reset
     std::string name;
-    std::vector<std::string> keys;
+    Execute::Keys keys;
 
     // <flags> is an arbitrary 16-bit unsigned integer (written out in decimal) that the server stores along with
     // the data and sends back when the item is retrieved. Clients may use this as a bit field to store data-specific
@@ -91,6 +114,10 @@ private:
     bool negative;
     std::string curKey;
     bool parse_complete;
+
+    // Command objects reused by Build
+    struct commands;
+    std::unique_ptr<commands> pool;
 };
 
 } // namespace Protocol
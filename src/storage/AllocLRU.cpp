@@ -0,0 +1,243 @@
+#include "AllocLRU.h"
+
+#include <cstring>
+
+#include <afina/Counters.h>
+#include <afina/allocator/Error.h>
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+inline bool IsExpired(std::time_t expire_at, std::time_t now) { return expire_at != 0 && expire_at <= now; }
+
+} // namespace
+
+// See AllocLRU.h
+AllocLRU::AllocLRU(size_t max_size)
+    : _max_size(max_size), _area(new char[max_size]), _allocator(_area.get(), max_size), _timers(std::time(nullptr)) {}
+
+// Free bytes are known, so eviction goes first and compaction is done at most once, when there is
+// enough free space but it is scattered over holes
+bool AllocLRU::Reserve(lru_entry &entry, size_t size) {
+    size_t needed = Allocator::Simple::footprint(size);
+    while (_allocator.available() < needed) {
+        if (_lru_head == nullptr) {
+            return false;
+        }
+        Remove(*_lru_head);
+        LocalCounters().evictions.Add();
+    }
+
+    try {
+        entry.data = _allocator.alloc(size);
+        return true;
+    } catch (Allocator::AllocError &error) {
+        if (error.getType() != Allocator::AllocErrorType::NoMemory) {
+            throw;
+        }
+    }
+
+    // Single region after defrag is large enough for sure
+    _allocator.defrag();
+    entry.data = _allocator.alloc(size);
+    return true;
+}
+
+bool AllocLRU::Insert(const std::string &key, const std::string &value, std::time_t expire_at) {
+    lru_entry *entry;
+    if (!_free_entries.empty()) {
+        entry = _free_entries.back();
+        _free_entries.pop_back();
+    } else {
+        _entries.emplace_back();
+        entry = &_entries.back();
+    }
+
+    if (!Reserve(*entry, key.size() + value.size())) {
+        _free_entries.push_back(entry);
+        return false;
+    }
+
+    entry->key_size = key.size();
+    entry->value_size = value.size();
+    std::memcpy(entry->key(), key.data(), key.size());
+    std::memcpy(entry->value(), value.data(), value.size());
+
+    _index.Insert(entry);
+    LinkToTail(*entry);
+    SetExpiration(*entry, expire_at);
+    return true;
+}
+
+// Old value is dropped before the new one is placed, so its block is counted as free. If the new
+// value doesn't fit, item is gone as it is in memcached
+bool AllocLRU::Update(lru_entry &entry, const std::string &key, const std::string &value, std::time_t expire_at) {
+    Remove(entry);
+    return Insert(key, value, expire_at);
+}
+
+void AllocLRU::Remove(lru_entry &entry) {
+    _index.Erase(entry.key(), entry.key_size);
+    Unlink(entry);
+    _timers.Cancel(entry);
+    _allocator.free(entry.data);
+
+    entry.expire_at = 0;
+    entry.key_size = entry.value_size = 0;
+    _free_entries.push_back(&entry);
+}
+
+void AllocLRU::SetExpiration(lru_entry &entry, std::time_t expire_at) {
+    if (entry.expire_at == expire_at) {
+        return;
+    }
+
+    _timers.Cancel(entry);
+    entry.expire_at = expire_at;
+    if (expire_at != 0) {
+        _timers.Schedule(entry);
+    }
+}
+
+void AllocLRU::Unlink(lru_entry &entry) {
+    if (entry.prev != nullptr) {
+        entry.prev->next = entry.next;
+    } else {
+        _lru_head = entry.next;
+    }
+
+    if (entry.next != nullptr) {
+        entry.next->prev = entry.prev;
+    } else {
+        _lru_tail = entry.prev;
+    }
+    entry.prev = entry.next = nullptr;
+}
+
+void AllocLRU::LinkToTail(lru_entry &entry) {
+    entry.prev = _lru_tail;
+    entry.next = nullptr;
+    if (_lru_tail != nullptr) {
+        _lru_tail->next = &entry;
+    } else {
+        _lru_head = &entry;
+    }
+    _lru_tail = &entry;
+}
+
+std::time_t AllocLRU::ExpireEntries() {
+    std::time_t now = std::time(nullptr);
+    _timers.Advance(now, [this](TimerWheel::Entry *entry) { Remove(*static_cast<lru_entry *>(entry)); });
+    return now;
+}
+
+AllocLRU::lru_entry *AllocLRU::FindAlive(const std::string &key) {
+    lru_entry *entry = _index.Find(key);
+    if (entry != nullptr && entry->expire_at != 0 && IsExpired(entry->expire_at, std::time(nullptr))) {
+        Remove(*entry);
+        return nullptr;
+    }
+    return entry;
+}
+
+// See AllocLRU.h
+bool AllocLRU::Put(const std::string &key, const std::string &value, std::time_t expire_at) {
+    if (IsTooBigForCache(key.size(), value.size())) {
+        return false;
+    }
+
+    std::time_t now = ExpireEntries();
+    lru_entry *entry = _index.Find(key);
+    if (IsExpired(expire_at, now)) {
+        // New value is stale already, the only visible effect is that the old one is gone
+        if (entry != nullptr) {
+            Remove(*entry);
+        }
+        return true;
+    }
+
+    if (entry == nullptr) {
+        return Insert(key, value, expire_at);
+    }
+    return Update(*entry, key, value, expire_at);
+}
+
+// See AllocLRU.h
+bool AllocLRU::PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at) {
+    if (IsTooBigForCache(key.size(), value.size())) {
+        return false;
+    }
+
+    std::time_t now = ExpireEntries();
+    if (_index.Find(key) != nullptr) {
+        return false;
+    }
+
+    if (IsExpired(expire_at, now)) {
+        return true;
+    }
+    return Insert(key, value, expire_at);
+}
+
+// See AllocLRU.h
+bool AllocLRU::Set(const std::string &key, const std::string &value, std::time_t expire_at) {
+    if (IsTooBigForCache(key.size(), value.size())) {
+        return false;
+    }
+
+    std::time_t now = ExpireEntries();
+    lru_entry *entry = _index.Find(key);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    if (IsExpired(expire_at, now)) {
+        Remove(*entry);
+        return true;
+    }
+    return Update(*entry, key, value, expire_at);
+}
+
+// See AllocLRU.h
+bool AllocLRU::Delete(const std::string &key) {
+    ExpireEntries();
+    lru_entry *entry = _index.Find(key);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    Remove(*entry);
+    return true;
+}
+
+// See AllocLRU.h
+void AllocLRU::FlushAll() {
+    while (_lru_head != nullptr) {
+        Remove(*_lru_head);
+    }
+}
+
+// See AllocLRU.h
+bool AllocLRU::Get(const std::string &key, std::string &value) {
+    std::time_t expire_at;
+    return AllocLRU::Get(key, value, expire_at);
+}
+
+// See AllocLRU.h
+bool AllocLRU::Get(const std::string &key, std::string &value, std::time_t &expire_at) {
+    lru_entry *entry = FindAlive(key);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    value.assign(entry->value(), entry->value_size);
+    expire_at = entry->expire_at;
+    Unlink(*entry);
+    LinkToTail(*entry);
+    return true;
+}
+
+} // namespace Backend
+} // namespace Afina
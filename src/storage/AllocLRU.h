@@ -0,0 +1,137 @@
+#ifndef AFINA_STORAGE_ALLOC_LRU_H
+#define AFINA_STORAGE_ALLOC_LRU_H
+
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/allocator/Pointer.h>
+#include <afina/allocator/Simple.h>
+
+#include "HashIndex.h"
+#include "TimerWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # LRU cache inside of a single preallocated area
+ * All keys and values live in the area of max_size bytes which is allocated once on start and
+ * managed by Allocator::Simple, so storage never takes more memory for the data than it was given.
+ * Allocator tracks free bytes, so storage evicts least recently used items until the new one fits
+ * and compacts area by defrag only if free space is enough but scattered over holes. That happens
+ * at most once per item, so there is no external fragmentation at a moderate cost.
+ *
+ * Only small fixed size record per item (LRU links, sizes and allocator handle) is kept outside.
+ * Defrag moves values around, so Pin copies the value.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class AllocLRU : public Afina::Storage {
+public:
+    AllocLRU(size_t max_size = 1024);
+    ~AllocLRU() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    void FlushAll() override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::time_t &expire_at) override;
+
+private:
+    AllocLRU(const AllocLRU &) = delete;
+    AllocLRU &operator=(const AllocLRU &) = delete;
+
+    // Record of the item, its data block keeps key bytes followed by value bytes
+    struct lru_entry : public TimerWheel::Entry {
+        Allocator::Pointer data;
+        uint32_t key_size = 0;
+        uint32_t value_size = 0;
+
+        lru_entry *prev = nullptr;
+        lru_entry *next = nullptr;
+
+        inline char *key() const { return static_cast<char *>(data.get()); }
+        inline char *value() const { return key() + key_size; }
+    };
+
+    // Key of the entry for the index
+    struct entry_key {
+        struct view {
+            const char *ptr;
+            size_t len;
+            inline const char *data() const { return ptr; }
+            inline size_t size() const { return len; }
+        };
+
+        view operator()(const lru_entry &entry) const { return view{entry.key(), entry.key_size}; }
+    };
+
+    // Descriptors table never shrinks, so the item is checked against space it leaves for blocks
+    // now rather than against the empty area
+    bool IsTooBigForCache(size_t key_size, size_t value_size) const {
+        return Allocator::Simple::footprint(key_size + value_size) > _allocator.available() + _allocator.used();
+    }
+
+    // Allocates data block for the entry, evicting other entries if needed. Returns false if entry
+    // doesn't fit even in the empty cache
+    bool Reserve(lru_entry &entry, size_t size);
+
+    bool Insert(const std::string &key, const std::string &value, std::time_t expire_at);
+    bool Update(lru_entry &entry, const std::string &key, const std::string &value, std::time_t expire_at);
+    void Remove(lru_entry &entry);
+    void SetExpiration(lru_entry &entry, std::time_t expire_at);
+
+    void Unlink(lru_entry &entry);
+    void LinkToTail(lru_entry &entry);
+
+    // Drops all entries expired by now, returns current time
+    std::time_t ExpireEntries();
+
+    // Finds entry which is not expired yet, expired one is dropped right away
+    lru_entry *FindAlive(const std::string &key);
+
+    // Size of the area
+    const size_t _max_size;
+
+    // Area keys and values live in
+    std::unique_ptr<char[]> _area;
+    Allocator::Simple _allocator;
+
+    // Records of items, deque never moves elements so they could be linked
+    std::deque<lru_entry> _entries;
+    std::vector<lru_entry *> _free_entries;
+
+    // LRU order, head is the least recently used entry
+    lru_entry *_lru_head = nullptr;
+    lru_entry *_lru_tail = nullptr;
+
+    HashIndex<lru_entry, entry_key> _index;
+
+    // Entries having expiration time
+    TimerWheel _timers;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_ALLOC_LRU_H
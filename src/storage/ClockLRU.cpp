@@ -0,0 +1,336 @@
+#include "ClockLRU.h"
+
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+
+#include <afina/Counters.h>
+#include <afina/allocator/Small.h>
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+// Scoped shared lock
+class ReadGuard {
+public:
+    ReadGuard(pthread_rwlock_t &lock, Concurrency::CoreRWLock *core_lock) : _lock(lock), _core_lock(core_lock) {
+        if (_core_lock != nullptr) {
+            _slot = _core_lock->ReadLock();
+        } else {
+            pthread_rwlock_rdlock(&_lock);
+        }
+    }
+    ~ReadGuard() {
+        if (_core_lock != nullptr) {
+            _core_lock->ReadUnlock(_slot);
+        } else {
+            pthread_rwlock_unlock(&_lock);
+        }
+    }
+
+private:
+    pthread_rwlock_t &_lock;
+    Concurrency::CoreRWLock *_core_lock;
+    size_t _slot;
+};
+
+// Scoped exclusive lock
+class WriteGuard {
+public:
+    WriteGuard(pthread_rwlock_t &lock, Concurrency::CoreRWLock *core_lock) : _lock(lock), _core_lock(core_lock) {
+        if (_core_lock != nullptr) {
+            _core_lock->WriteLock();
+        } else {
+            pthread_rwlock_wrlock(&_lock);
+        }
+    }
+    ~WriteGuard() {
+        if (_core_lock != nullptr) {
+            _core_lock->WriteUnlock();
+        } else {
+            pthread_rwlock_unlock(&_lock);
+        }
+    }
+
+private:
+    pthread_rwlock_t &_lock;
+    Concurrency::CoreRWLock *_core_lock;
+};
+
+inline bool IsExpired(std::time_t expire_at, std::time_t now) { return expire_at != 0 && expire_at <= now; }
+
+} // namespace
+
+// See ClockLRU.h
+ClockLRU::ClockLRU(size_t max_size, bool core_local_readers)
+    : _max_size(max_size), _cur_size(0), _hand(0), _timers(std::time(nullptr)),
+      _core_lock(core_local_readers ? new Concurrency::CoreRWLock() : nullptr) {
+    // Reads are dominating, so without writer preference modifications could starve
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    if (pthread_rwlock_init(&_lock, &attr) != 0) {
+        pthread_rwlockattr_destroy(&attr);
+        throw std::runtime_error("Failed to init rwlock");
+    }
+    pthread_rwlockattr_destroy(&attr);
+}
+
+// See ClockLRU.h
+ClockLRU::~ClockLRU() {
+    for (auto &slot : _slots) {
+        if (slot.used) {
+            ReleaseValue(slot.value);
+        }
+    }
+    pthread_rwlock_destroy(&_lock);
+}
+
+ClockLRU::clock_value *ClockLRU::NewValue(const std::string &value) {
+    // Last reference is often dropped by reader thread, Small takes such frees without locks
+    void *mem = Allocator::Small::Alloc(sizeof(clock_value) + value.size());
+    clock_value *result = new (mem) clock_value();
+    result->refs.store(1, std::memory_order_relaxed);
+    result->size = value.size();
+    std::memcpy(reinterpret_cast<char *>(result + 1), value.data(), value.size());
+    return result;
+}
+
+void ClockLRU::ReleaseValue(clock_value *value) {
+    if (value->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        size_t size = value->size;
+        value->~clock_value();
+        Allocator::Small::Free(value, sizeof(clock_value) + size);
+    }
+}
+
+void ClockLRU::Evict(clock_slot &slot) {
+    _cur_size -= slot.key.size() + slot.value->size;
+    _index.Erase(slot.key.data(), slot.key.size());
+    ReleaseValue(slot.value);
+    _timers.Cancel(slot);
+
+    slot.key.clear();
+    slot.expire_at = 0;
+    slot.value = nullptr;
+    slot.used = false;
+    slot.referenced.store(false, std::memory_order_relaxed);
+    _free_slots.push_back(&slot);
+}
+
+void ClockLRU::SetExpiration(clock_slot &slot, std::time_t expire_at) {
+    if (slot.expire_at == expire_at) {
+        return;
+    }
+
+    _timers.Cancel(slot);
+    slot.expire_at = expire_at;
+    if (expire_at != 0) {
+        _timers.Schedule(slot);
+    }
+}
+
+std::time_t ClockLRU::ExpireEntries() {
+    std::time_t now = std::time(nullptr);
+    _timers.Advance(now, [this](TimerWheel::Entry *entry) { Evict(*static_cast<clock_slot *>(entry)); });
+    return now;
+}
+
+ClockLRU::clock_slot *ClockLRU::FindAlive(const std::string &key) const {
+    clock_slot *slot = _index.Find(key);
+    if (slot != nullptr && slot->expire_at != 0 && IsExpired(slot->expire_at, std::time(nullptr))) {
+        return nullptr;
+    }
+    return slot;
+}
+
+void ClockLRU::FreeSpace(size_t required, const clock_slot *keep) {
+    while (_cur_size + required > _max_size) {
+        if (_hand >= _slots.size()) {
+            _hand = 0;
+        }
+
+        clock_slot &slot = _slots[_hand++];
+        if (!slot.used || &slot == keep) {
+            continue;
+        }
+
+        // Second chance
+        if (slot.referenced.exchange(false, std::memory_order_relaxed)) {
+            continue;
+        }
+        Evict(slot);
+        LocalCounters().evictions.Add();
+    }
+}
+
+void ClockLRU::Insert(const std::string &key, const std::string &value, std::time_t expire_at) {
+    FreeSpace(key.size() + value.size());
+
+    clock_slot *slot;
+    if (!_free_slots.empty()) {
+        slot = _free_slots.back();
+        _free_slots.pop_back();
+    } else {
+        _slots.emplace_back();
+        slot = &_slots.back();
+    }
+
+    slot->key.assign(key.data(), key.size());
+    slot->value = NewValue(value);
+    slot->used = true;
+    slot->referenced.store(false, std::memory_order_relaxed);
+    _index.Insert(slot);
+    SetExpiration(*slot, expire_at);
+    _cur_size += key.size() + value.size();
+}
+
+void ClockLRU::Update(clock_slot &slot, const std::string &value, std::time_t expire_at) {
+    if (value.size() > slot.value->size) {
+        FreeSpace(value.size() - slot.value->size, &slot);
+    }
+
+    clock_value *old = slot.value;
+    slot.value = NewValue(value);
+    _cur_size = _cur_size - old->size + value.size();
+    SetExpiration(slot, expire_at);
+    Touch(slot);
+    ReleaseValue(old);
+}
+
+// See ClockLRU.h
+bool ClockLRU::Put(const std::string &key, const std::string &value, std::time_t expire_at) {
+    if (IsTooBigForCache(key.size(), value.size())) {
+        return false;
+    }
+
+    WriteGuard guard(_lock, _core_lock.get());
+    std::time_t now = ExpireEntries();
+    clock_slot *slot = _index.Find(key);
+    if (IsExpired(expire_at, now)) {
+        // New value is stale already, the only visible effect is that the old one is gone
+        if (slot != nullptr) {
+            Evict(*slot);
+        }
+    } else if (slot == nullptr) {
+        Insert(key, value, expire_at);
+    } else {
+        Update(*slot, value, expire_at);
+    }
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at) {
+    if (IsTooBigForCache(key.size(), value.size())) {
+        return false;
+    }
+
+    WriteGuard guard(_lock, _core_lock.get());
+    std::time_t now = ExpireEntries();
+    if (_index.Find(key) != nullptr) {
+        return false;
+    }
+    if (!IsExpired(expire_at, now)) {
+        Insert(key, value, expire_at);
+    }
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Set(const std::string &key, const std::string &value, std::time_t expire_at) {
+    if (IsTooBigForCache(key.size(), value.size())) {
+        return false;
+    }
+
+    WriteGuard guard(_lock, _core_lock.get());
+    std::time_t now = ExpireEntries();
+    clock_slot *slot = _index.Find(key);
+    if (slot == nullptr) {
+        return false;
+    }
+
+    if (IsExpired(expire_at, now)) {
+        Evict(*slot);
+    } else {
+        Update(*slot, value, expire_at);
+    }
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Delete(const std::string &key) {
+    WriteGuard guard(_lock, _core_lock.get());
+    ExpireEntries();
+    clock_slot *slot = _index.Find(key);
+    if (slot == nullptr) {
+        return false;
+    }
+    Evict(*slot);
+    return true;
+}
+
+// See ClockLRU.h
+void ClockLRU::FlushAll() {
+    WriteGuard guard(_lock, _core_lock.get());
+    for (auto &slot : _slots) {
+        if (slot.used) {
+            ReleaseValue(slot.value);
+        }
+    }
+
+    _slots.clear();
+    _free_slots.clear();
+    _index.Clear();
+    _timers.Clear();
+    _hand = 0;
+    _cur_size = 0;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Get(const std::string &key, std::string &value) {
+    std::time_t expire_at;
+    return ClockLRU::Get(key, value, expire_at);
+}
+
+// See ClockLRU.h
+bool ClockLRU::Get(const std::string &key, std::string &value, std::time_t &expire_at) {
+    ReadGuard guard(_lock, _core_lock.get());
+    clock_slot *slot = FindAlive(key);
+    if (slot == nullptr) {
+        return false;
+    }
+
+    Touch(*slot);
+    value.assign(slot->value->data(), slot->value->size);
+    expire_at = slot->expire_at;
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Pin(const std::string &key, ValueView &value) {
+    // Previous value is released outside of the lock
+    value.Reset();
+
+    clock_value *pinned;
+    {
+        ReadGuard guard(_lock, _core_lock.get());
+        clock_slot *slot = FindAlive(key);
+        if (slot == nullptr) {
+            return false;
+        }
+
+        Touch(*slot);
+        pinned = slot->value;
+        pinned->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    value = ValueView(pinned->data(), pinned->size, &ClockLRU::ReleasePin, nullptr, pinned);
+    return true;
+}
+
+} // namespace Backend
+} // namespace Afina
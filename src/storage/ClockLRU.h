@@ -0,0 +1,165 @@
+#ifndef AFINA_STORAGE_CLOCK_LRU_H
+#define AFINA_STORAGE_CLOCK_LRU_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+#include <afina/Storage.h>
+#include <afina/allocator/Small.h>
+#include <afina/concurrency/CoreRWLock.h>
+
+#include "HashIndex.h"
+#include "TimerWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # CLOCK (second chance) cache
+ * Approximates LRU without maintaining recency order: each entry has a "referenced" bit that
+ * read sets, while eviction is done by a hand sweeping over entries in a circle. Entry that has
+ * bit set gets second chance - bit is cleared and hand moves on, otherwise entry is evicted.
+ *
+ * Since hit doesn't change any shared structure except an atomic bit, reads are executed under
+ * shared lock and never block each other. Modifications take exclusive lock.
+ *
+ * Readers can't remove anything, so they just skip expired entries, while writers reclaim them
+ * with the timer wheel before going to evict anything.
+ *
+ * With core local readers every CPU has own lock for readers, so concurrent hits on different cores
+ * don't bounce the reader counter between them, but every modification locks all CPUs.
+ *
+ * Thread safe implementation
+ */
+class ClockLRU : public Afina::Storage {
+public:
+    /**
+     * @param max_size memory budget for keys and values
+     * @param core_local_readers readers take lock of their CPU only, see Concurrency::CoreRWLock
+     */
+    ClockLRU(size_t max_size = 1024, bool core_local_readers = false);
+    ~ClockLRU();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    void FlushAll() override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::time_t &expire_at) override;
+
+    // Implements Afina::Storage interface
+    bool Pin(const std::string &key, ValueView &value) override;
+
+private:
+    ClockLRU(const ClockLRU &) = delete;
+    ClockLRU &operator=(const ClockLRU &) = delete;
+
+    // Reference counted value, header is followed by value bytes. Readers could hold value
+    // after it was replaced in the cache
+    struct clock_value {
+        std::atomic<uint32_t> refs;
+        size_t size;
+
+        inline const char *data() const { return reinterpret_cast<const char *>(this + 1); }
+    };
+
+    // Keys are allocated by writers from any thread, keep them in the per thread pools
+    typedef std::basic_string<char, std::char_traits<char>, Allocator::SmallAllocator<char>> key_string;
+
+    // Position on the clock, slot of entry with expiration time is kept in the timer wheel
+    struct clock_slot : public TimerWheel::Entry {
+        clock_slot() : value(nullptr), referenced(false), used(false) {}
+
+        key_string key;
+        clock_value *value;
+
+        // Second chance bit, the only field that could be changed under shared lock
+        std::atomic<bool> referenced;
+
+        // Slot keeps some entry
+        bool used;
+    };
+
+    // Key of the slot for the index
+    struct slot_key {
+        const key_string &operator()(const clock_slot &slot) const { return slot.key; }
+    };
+
+    static clock_value *NewValue(const std::string &value);
+    static void ReleaseValue(clock_value *value);
+    static void ReleasePin(void *, void *item) { ReleaseValue(static_cast<clock_value *>(item)); }
+
+    // Marks slot as recently used
+    static inline void Touch(clock_slot &slot) {
+        // Avoid to dirty cache line if bit is already set
+        if (!slot.referenced.load(std::memory_order_relaxed)) {
+            slot.referenced.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    bool IsTooBigForCache(size_t key_size, size_t value_size) const { return key_size + value_size > _max_size; }
+
+    // Runs clock hand until there is enough space for required bytes, never evicts given slot
+    void FreeSpace(size_t required, const clock_slot *keep = nullptr);
+
+    void Insert(const std::string &key, const std::string &value, std::time_t expire_at);
+    void Update(clock_slot &slot, const std::string &value, std::time_t expire_at);
+    void Evict(clock_slot &slot);
+    void SetExpiration(clock_slot &slot, std::time_t expire_at);
+
+    // Evicts all entries expired by now, returns current time. Must be called under exclusive lock
+    std::time_t ExpireEntries();
+
+    // Finds entry which is not expired yet
+    clock_slot *FindAlive(const std::string &key) const;
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be not greater than the _max_size
+    const size_t _max_size;
+    size_t _cur_size;
+
+    // Clock itself, deque never moves elements, so index could point to them
+    std::deque<clock_slot> _slots;
+
+    // Unused slots
+    std::vector<clock_slot *> _free_slots;
+
+    // Position of the clock hand
+    size_t _hand;
+
+    // Index of used slots
+    HashIndex<clock_slot, slot_key> _index;
+
+    // Slots of entries having expiration time
+    TimerWheel _timers;
+
+    // Readers take lock in shared mode, all modifications are done in exclusive one. Per CPU lock
+    // is used instead if there is one
+    pthread_rwlock_t _lock;
+    std::unique_ptr<Concurrency::CoreRWLock> _core_lock;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CLOCK_LRU_H
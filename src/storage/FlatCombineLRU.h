@@ -0,0 +1,170 @@
+#ifndef AFINA_STORAGE_FLAT_COMBINE_LRU_H
+#define AFINA_STORAGE_FLAT_COMBINE_LRU_H
+
+#include <new>
+#include <string>
+
+#include <afina/concurrency/FlatCombine.h>
+
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # SimpleLRU thread safe version on top of flat combining
+ * Instead of taking a lock each thread publishes operation and one of them applies the whole batch
+ * to the cache. List head and tail together with index buckets stay in the cache of the combiner
+ * for the batch, while with a mutex they move to the core of every next lock owner.
+ *
+ * Thread safe implementation
+ */
+class FlatCombineLRU : public SimpleLRU {
+public:
+    FlatCombineLRU(size_t max_size = 1024)
+        : SimpleLRU(max_size), _combine([this](operation *const *ops, size_t count) { Apply(ops, count); }) {}
+    ~FlatCombineLRU() {}
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
+        operation op(operation::kPut, &key);
+        op.value = &value;
+        op.expire_at = expire_at;
+        return Execute(op);
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
+        operation op(operation::kPutIfAbsent, &key);
+        op.value = &value;
+        op.expire_at = expire_at;
+        return Execute(op);
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
+        operation op(operation::kSet, &key);
+        op.value = &value;
+        op.expire_at = expire_at;
+        return Execute(op);
+    }
+
+    // see SimpleLRU.h
+    bool Delete(const std::string &key) override {
+        operation op(operation::kDelete, &key);
+        return Execute(op);
+    }
+
+    // see SimpleLRU.h
+    void FlushAll() override {
+        operation op(operation::kFlushAll, nullptr);
+        Execute(op);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value) override {
+        operation op(operation::kGet, &key);
+        op.out = &value;
+        return Execute(op);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value, std::time_t &expire_at) override {
+        operation op(operation::kGet, &key);
+        op.out = &value;
+        if (!Execute(op)) {
+            return false;
+        }
+        expire_at = op.expire_at;
+        return true;
+    }
+
+    // see SimpleLRU.h
+    bool Pin(const std::string &key, ValueView &value) override {
+        // Releasing previous value calls Unpin, which must not happen inside of the combiner
+        value.Reset();
+
+        operation op(operation::kPin, &key);
+        op.view = &value;
+        return Execute(op);
+    }
+
+protected:
+    // see SimpleLRU.h
+    void Unpin(void *item) override {
+        operation op(operation::kUnpin, nullptr);
+        op.item = item;
+        Execute(op);
+    }
+
+private:
+    /**
+     * Request published by a thread, fields used depend on the type
+     */
+    struct operation {
+        enum Type { kPut, kPutIfAbsent, kSet, kDelete, kFlushAll, kGet, kPin, kUnpin };
+
+        operation(Type t, const std::string *k) : type(t), key(k) {}
+
+        Type type;
+        const std::string *key;
+        const std::string *value = nullptr;
+        // Get puts expiration time of the value here
+        std::time_t expire_at = 0;
+        std::string *out = nullptr;
+        ValueView *view = nullptr;
+        void *item = nullptr;
+
+        // Filled in by combiner
+        bool result = false;
+    };
+
+    bool Execute(operation &op) {
+        _combine.Execute(op);
+        return op.result;
+    }
+
+    // Runs on the combiner thread
+    void Apply(operation *const *ops, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            operation &op = *ops[i];
+            try {
+                op.result = ApplyOne(op);
+            } catch (std::bad_alloc &) {
+                // Combiner must not throw, that would leave other threads waiting forever
+                op.result = false;
+            }
+        }
+    }
+
+    bool ApplyOne(operation &op) {
+        switch (op.type) {
+        case operation::kPut:
+            return SimpleLRU::Put(*op.key, *op.value, op.expire_at);
+        case operation::kPutIfAbsent:
+            return SimpleLRU::PutIfAbsent(*op.key, *op.value, op.expire_at);
+        case operation::kSet:
+            return SimpleLRU::Set(*op.key, *op.value, op.expire_at);
+        case operation::kDelete:
+            return SimpleLRU::Delete(*op.key);
+        case operation::kFlushAll:
+            SimpleLRU::FlushAll();
+            return true;
+        case operation::kGet:
+            return SimpleLRU::Get(*op.key, *op.out, op.expire_at);
+        case operation::kPin:
+            return SimpleLRU::Pin(*op.key, *op.view);
+        case operation::kUnpin:
+            SimpleLRU::Unpin(op.item);
+            return true;
+        }
+        return false;
+    }
+
+    Concurrency::FlatCombine<operation> _combine;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FLAT_COMBINE_LRU_H
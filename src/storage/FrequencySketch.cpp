@@ -0,0 +1,66 @@
+#include "FrequencySketch.h"
+
+#include <algorithm>
+
+namespace Afina {
+namespace Backend {
+
+// See FrequencySketch.h
+FrequencySketch::FrequencySketch(size_t expected_items) : _additions(0) {
+    // At least one word per row
+    size_t width = 16;
+    while (width < expected_items) {
+        width <<= 1;
+    }
+
+    _row_mask = width - 1;
+    _row_words = width / 16;
+    _table.assign(kRows * _row_words, 0);
+    _sample_size = 10 * width;
+}
+
+void FrequencySketch::Locate(uint64_t hash, size_t row, size_t &word, size_t &shift) const {
+    // Double hashing gives independent enough index for each row
+    uint32_t h1 = uint32_t(hash), h2 = uint32_t(hash >> 32) | 1;
+    size_t index = (h1 + row * h2) & _row_mask;
+    word = row * _row_words + index / 16;
+    shift = (index % 16) * 4;
+}
+
+// See FrequencySketch.h
+void FrequencySketch::Increment(uint64_t hash) {
+    bool added = false;
+    for (size_t row = 0; row < kRows; row++) {
+        size_t word, shift;
+        Locate(hash, row, word, shift);
+        if (((_table[word] >> shift) & kMaxCount) != kMaxCount) {
+            _table[word] += uint64_t(1) << shift;
+            added = true;
+        }
+    }
+
+    if (added && ++_additions >= _sample_size) {
+        Reset();
+    }
+}
+
+// See FrequencySketch.h
+uint32_t FrequencySketch::Estimate(uint64_t hash) const {
+    uint32_t result = kMaxCount;
+    for (size_t row = 0; row < kRows; row++) {
+        size_t word, shift;
+        Locate(hash, row, word, shift);
+        result = std::min(result, uint32_t((_table[word] >> shift) & kMaxCount));
+    }
+    return result;
+}
+
+void FrequencySketch::Reset() {
+    for (auto &word : _table) {
+        word = (word >> 1) & 0x7777777777777777ULL;
+    }
+    _additions /= 2;
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,62 @@
+#ifndef AFINA_STORAGE_FREQUENCY_SKETCH_H
+#define AFINA_STORAGE_FREQUENCY_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Count-min sketch of access frequency
+ * Each key is counted in 4 rows of 4-bit saturating counters, estimate is the minimum over rows,
+ * so it is never less than the real number of accesses but could be bigger due to collisions.
+ *
+ * Once number of increments reaches sample size all counters are halved, so that keys which were
+ * popular long time ago don't stay in the cache forever.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class FrequencySketch {
+public:
+    /**
+     * @param expected_items number of distinct keys sketch is sized for
+     */
+    FrequencySketch(size_t expected_items);
+
+    /**
+     * Counts one more access of key with the given hash
+     */
+    void Increment(uint64_t hash);
+
+    /**
+     * Returns estimated number of accesses of key with the given hash, up to 15
+     */
+    uint32_t Estimate(uint64_t hash) const;
+
+private:
+    static const size_t kRows = 4;
+    static const uint32_t kMaxCount = 15;
+
+    // Position of the counter in the table
+    void Locate(uint64_t hash, size_t row, size_t &word, size_t &shift) const;
+
+    // Halves all counters
+    void Reset();
+
+    // Rows one after another, each word packs 16 counters
+    std::vector<uint64_t> _table;
+
+    // Number of counters in a row minus one, row width is power of 2
+    size_t _row_mask;
+    size_t _row_words;
+
+    size_t _additions;
+    size_t _sample_size;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FREQUENCY_SKETCH_H
@@ -0,0 +1,247 @@
+#ifndef AFINA_STORAGE_HASH_INDEX_H
+#define AFINA_STORAGE_HASH_INDEX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * MurmurHash64A over the given bytes, see https://github.com/aappleby/smhasher
+ */
+inline uint64_t HashBytes(const char *data, size_t len, uint64_t seed = 0x5bd1e9955bd1e995ULL) {
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+
+    uint64_t h = seed ^ (len * m);
+
+    const char *end = data + (len & ~size_t(7));
+    for (; data != end; data += 8) {
+        uint64_t k;
+        std::memcpy(&k, data, sizeof(k));
+
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+
+        h ^= k;
+        h *= m;
+    }
+
+    switch (len & 7) {
+    case 7:
+        h ^= uint64_t(static_cast<unsigned char>(data[6])) << 48;
+        // fallthrough
+    case 6:
+        h ^= uint64_t(static_cast<unsigned char>(data[5])) << 40;
+        // fallthrough
+    case 5:
+        h ^= uint64_t(static_cast<unsigned char>(data[4])) << 32;
+        // fallthrough
+    case 4:
+        h ^= uint64_t(static_cast<unsigned char>(data[3])) << 24;
+        // fallthrough
+    case 3:
+        h ^= uint64_t(static_cast<unsigned char>(data[2])) << 16;
+        // fallthrough
+    case 2:
+        h ^= uint64_t(static_cast<unsigned char>(data[1])) << 8;
+        // fallthrough
+    case 1:
+        h ^= uint64_t(static_cast<unsigned char>(data[0]));
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+/**
+ * # Open addressing hash index
+ * Maps key to the node that owns it. Index doesn't own nodes and doesn't store keys, instead
+ * each bucket keeps node pointer along with precomputed hash, so that most of mismatches are
+ * rejected without touching node memory at all.
+ *
+ * Collisions are resolved by linear probing with Robin Hood displacement: element that is far
+ * away from its home bucket takes place of the one which is closer to home. That keeps probe
+ * sequences short and allows to stop lookup early. Erase uses backward shift, so there are no
+ * tombstones.
+ *
+ * KeyOf is a functor that returns key of the node as anything that has data() and size()
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+template <typename Node, typename KeyOf> class HashIndex {
+public:
+    HashIndex(size_t capacity = 16) : _size(0) { Rehash(RoundUp(capacity)); }
+
+    /**
+     * Returns node associated with the given key or nullptr if there is no such
+     */
+    Node *Find(const char *key, size_t len) const { return Find(key, len, HashBytes(key, len)); }
+    Node *Find(const std::string &key) const { return Find(key.data(), key.size()); }
+
+    /**
+     * Same as above, but uses hash calculated by caller, see HashBytes
+     */
+    Node *Find(const char *key, size_t len, uint64_t hash) const {
+        const bucket *b = Lookup(key, len, hash);
+        return b == nullptr ? nullptr : b->node;
+    }
+
+    /**
+     * Adds node into the index. If there is another node with the same key already then
+     * method returns false and doesn't change anything
+     */
+    bool Insert(Node *node) {
+        const auto &key = KeyOf()(*node);
+        uint64_t hash = HashBytes(key.data(), key.size());
+        if (Find(key.data(), key.size(), hash) != nullptr) {
+            return false;
+        }
+
+        if ((_size + 1) * 8 > _buckets.size() * 7) {
+            Rehash(_buckets.size() * 2);
+        }
+        Place(bucket{hash, node});
+        _size++;
+        return true;
+    }
+
+    /**
+     * Replace node associated with the key of the given one. Returns false if there is no such
+     * key in the index
+     */
+    bool Replace(Node *node) {
+        const auto &key = KeyOf()(*node);
+        const bucket *b = Lookup(key.data(), key.size(), HashBytes(key.data(), key.size()));
+        if (b == nullptr) {
+            return false;
+        }
+        const_cast<bucket *>(b)->node = node;
+        return true;
+    }
+
+    /**
+     * Removes key from the index and returns node it was associated with or nullptr if there
+     * was no such key
+     */
+    Node *Erase(const char *key, size_t len) {
+        const bucket *b = Lookup(key, len, HashBytes(key, len));
+        if (b == nullptr) {
+            return nullptr;
+        }
+
+        Node *result = b->node;
+        size_t mask = _buckets.size() - 1;
+        size_t pos = b - &_buckets[0];
+
+        // Backward shift: pull following elements of the probe sequence one step closer to home
+        for (;;) {
+            size_t next = (pos + 1) & mask;
+            bucket &n = _buckets[next];
+            if (n.node == nullptr || Distance(n, next) == 0) {
+                break;
+            }
+            _buckets[pos] = n;
+            pos = next;
+        }
+        _buckets[pos] = bucket{0, nullptr};
+        _size--;
+        return result;
+    }
+    Node *Erase(const std::string &key) { return Erase(key.data(), key.size()); }
+
+    /**
+     * Drop all associations, memory allocated for buckets stays for reuse
+     */
+    void Clear() {
+        std::fill(_buckets.begin(), _buckets.end(), bucket{0, nullptr});
+        _size = 0;
+    }
+
+    inline size_t Size() const { return _size; }
+
+private:
+    struct bucket {
+        uint64_t hash;
+        Node *node;
+    };
+
+    static size_t RoundUp(size_t capacity) {
+        size_t result = 16;
+        while (result < capacity) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    static bool Equals(const Node &node, const char *key, size_t len) {
+        const auto &node_key = KeyOf()(node);
+        return node_key.size() == len && std::memcmp(node_key.data(), key, len) == 0;
+    }
+
+    // How far bucket at the given position from the home one of the element it stores
+    inline size_t Distance(const bucket &b, size_t pos) const { return (pos - b.hash) & (_buckets.size() - 1); }
+
+    const bucket *Lookup(const char *key, size_t len, uint64_t hash) const {
+        size_t mask = _buckets.size() - 1;
+        size_t pos = hash & mask;
+        for (size_t dist = 0;; dist++, pos = (pos + 1) & mask) {
+            const bucket &b = _buckets[pos];
+            if (b.node == nullptr || Distance(b, pos) < dist) {
+                return nullptr;
+            }
+            if (b.hash == hash && Equals(*b.node, key, len)) {
+                return &b;
+            }
+        }
+    }
+
+    // Robin Hood insertion of the element known to be absent
+    void Place(bucket b) {
+        size_t mask = _buckets.size() - 1;
+        size_t pos = b.hash & mask;
+        for (size_t dist = 0;; dist++, pos = (pos + 1) & mask) {
+            bucket &cur = _buckets[pos];
+            if (cur.node == nullptr) {
+                cur = b;
+                return;
+            }
+
+            size_t cur_dist = Distance(cur, pos);
+            if (cur_dist < dist) {
+                std::swap(cur, b);
+                dist = cur_dist;
+            }
+        }
+    }
+
+    void Rehash(size_t capacity) {
+        std::vector<bucket> old(capacity, bucket{0, nullptr});
+        old.swap(_buckets);
+        for (auto &b : old) {
+            if (b.node != nullptr) {
+                Place(b);
+            }
+        }
+    }
+
+    // Number of elements in the index
+    size_t _size;
+
+    // Open addressing table, size is always power of 2
+    std::vector<bucket> _buckets;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_HASH_INDEX_H
@@ -1,188 +1,359 @@
 #include "SimpleLRU.h"
 
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+#include <afina/Counters.h>
+
 namespace Afina {
 namespace Backend {
 
-std::unique_ptr<SimpleLRU::lru_node> SimpleLRU::ExtractHead() {
-  std::unique_ptr<lru_node> res = std::move(_lru_head);
-  _lru_head = std::move(res->next);
-  if (_lru_head) {
-    _lru_head->prev = nullptr;
+namespace {
+
+// Slab page never needs to be much larger than the whole cache
+size_t SlabPageSize(size_t max_size) {
+  const size_t min_page = 4 * 1024, max_page = 1024 * 1024;
+  return std::min(max_page, std::max(min_page, max_size));
+}
+
+inline bool IsExpired(std::time_t expire_at, std::time_t now) { return expire_at != 0 && expire_at <= now; }
+
+} // namespace
+
+SimpleLRU::SimpleLRU(size_t max_size)
+    : _max_size(max_size), _slabs(SlabPageSize(max_size)), _timers(std::time(nullptr)) {}
+
+// Nodes memory belongs to the slab allocator, so there is no need to walk the list
+SimpleLRU::~SimpleLRU() {}
+
+SimpleLRU::lru_node *SimpleLRU::AllocateNode(const std::string &key, const std::string &value) {
+  uint8_t slab_class;
+  void *chunk = _slabs.Allocate(sizeof(lru_node) + key.size() + value.size(), slab_class);
+
+  lru_node *node = static_cast<lru_node *>(chunk);
+  node->prev = nullptr;
+  node->next = nullptr;
+  node->prev_timer = nullptr;
+  node->next_timer = nullptr;
+  node->expire_at = 0;
+  node->key_size = key.size();
+  node->value_size = value.size();
+  node->slab_class = slab_class;
+  node->zombie = false;
+  node->pins = 0;
+  std::memcpy(node->key(), key.data(), key.size());
+  std::memcpy(node->value(), value.data(), value.size());
+  return node;
+}
+
+void SimpleLRU::FreeNode(lru_node *node) { _slabs.Free(node, node->slab_class); }
+
+// Node is not in the list and the index anymore. Someone could still read its value, in this
+// case memory is released on the last Unpin
+void SimpleLRU::Retire(lru_node *node) {
+  if (node->pins > 0) {
+    node->zombie = true;
+  } else {
+    FreeNode(node);
   }
-  return res;
 }
 
-std::unique_ptr<SimpleLRU::lru_node> SimpleLRU::ExtractTail() {
-  std::unique_ptr<lru_node> res(_lru_tail);
-  _lru_tail = _lru_tail->prev;
-  _lru_tail->next.release();
-  _lru_tail->next = nullptr;
-  return res;
+void SimpleLRU::RemoveNode(lru_node *node) {
+  _cur_size -= node->key_size + node->value_size;
+  _lru_index.Erase(node->key(), node->key_size);
+  Unlink(*node);
+  _timers.Cancel(*node);
+  Retire(node);
 }
 
-std::unique_ptr<SimpleLRU::lru_node> SimpleLRU::ExtractNode(hash_map::const_iterator it) {
-  lru_node &del_node = it->second.get();
-  if (del_node.prev == nullptr) {
-    return ExtractHead();
+void SimpleLRU::SetExpiration(lru_node &node, std::time_t expire_at) {
+  if (node.expire_at == expire_at) {
+    return;
   }
 
-  if (del_node.next == nullptr) {
-    return ExtractTail();
+  _timers.Cancel(node);
+  node.expire_at = expire_at;
+  if (expire_at != 0) {
+    _timers.Schedule(node);
   }
+}
 
-  del_node.next->prev = del_node.prev;
-  std::unique_ptr<lru_node> res = std::move(del_node.prev->next);
-  del_node.prev->next = std::move(del_node.next);
-  return res;
+std::time_t SimpleLRU::ExpireItems() {
+  std::time_t now = std::time(nullptr);
+  _timers.Advance(now, [this](TimerWheel::Entry *entry) { RemoveNode(static_cast<lru_node *>(entry)); });
+  return now;
 }
 
+SimpleLRU::lru_node *SimpleLRU::FindAlive(const std::string &key) {
+  lru_node *node = _lru_index.Find(key);
+  if (node != nullptr && node->expire_at != 0 && IsExpired(node->expire_at, std::time(nullptr))) {
+    RemoveNode(node);
+    return nullptr;
+  }
+  return node;
+}
+
+void SimpleLRU::Unlink(lru_node &node) {
+  if (node.prev != nullptr) {
+    node.prev->next = node.next;
+  } else {
+    _lru_head = node.next;
+  }
+
+  if (node.next != nullptr) {
+    node.next->prev = node.prev;
+  } else {
+    _lru_tail = node.prev;
+  }
+  node.prev = node.next = nullptr;
+}
 
-void SimpleLRU::UpdateValue(hash_map::const_iterator it, const std::string &value) {
-  _cur_size += value.size() - it->second.get().value.size();
-  it->second.get().value = value;
+void SimpleLRU::LinkToTail(lru_node &node) {
+  node.prev = _lru_tail;
+  node.next = nullptr;
+  if (_lru_tail != nullptr) {
+    _lru_tail->next = &node;
+  } else {
+    _lru_head = &node;
+  }
+  _lru_tail = &node;
+}
+
+void SimpleLRU::MoveToTail(lru_node &node) {
+  if (&node == _lru_tail) {
+    return;
+  }
+  Unlink(node);
+  LinkToTail(node);
 }
 
 bool SimpleLRU::IsTooBigForCache(size_t key_size, size_t value_size) {
  return key_size + value_size > _max_size;
 }
 
-void SimpleLRU::FreeSpace(int delta_space) {
-  while (delta_space + _cur_size > _max_size) {
-    const std::string &del_key = _lru_head->key;
-    _cur_size -= del_key.size() + _lru_head->value.size();
-
-    auto it = _lru_index.find(del_key);
-    auto temp = ExtractHead();
-    _lru_index.erase(it);
+void SimpleLRU::FreeSpace(size_t required) {
+  while (required + _cur_size > _max_size) {
+    RemoveNode(_lru_head);
+    LocalCounters().evictions.Add();
   }
 }
 
- SimpleLRU::lru_node* SimpleLRU::AddToHash(const std::string &key, const std::string &value)  {
-  lru_node *temp = new lru_node({key, value, _lru_tail, nullptr});
-  auto res = _lru_index.emplace(temp->key, *temp);
-  if (!res.second) {
-    delete temp;
-    return nullptr;
+// Node must be the freshest one, so that it doesn't get evicted while freeing space for the
+// new value
+void SimpleLRU::UpdateValue(lru_node *node, const std::string &value, std::time_t expire_at) {
+  if (value.size() > node->value_size) {
+    FreeSpace(value.size() - node->value_size);
+  }
+  _cur_size = _cur_size - node->value_size + value.size();
+
+  // Pinned value must stay intact, so it is never overwritten in place
+  size_t required = sizeof(lru_node) + node->key_size + value.size();
+  if (node->pins == 0 &&
+      required <= _slabs.ChunkSize(node->slab_class, sizeof(lru_node) + node->key_size + node->value_size)) {
+    node->value_size = value.size();
+    std::memcpy(node->value(), value.data(), value.size());
+    SetExpiration(*node, expire_at);
+    return;
   }
-  return temp;
+
+  // Doesn't fit into current chunk anymore, move node to the chunk of bigger class
+  uint8_t slab_class;
+  lru_node *moved = static_cast<lru_node *>(_slabs.Allocate(required, slab_class));
+  _timers.Cancel(*node);
+  std::memcpy(moved, node, sizeof(lru_node) + node->key_size);
+  moved->expire_at = 0;
+  moved->slab_class = slab_class;
+  moved->pins = 0;
+  moved->value_size = value.size();
+  std::memcpy(moved->value(), value.data(), value.size());
+
+  Unlink(*node);
+  LinkToTail(*moved);
+  _lru_index.Replace(moved);
+  SetExpiration(*moved, expire_at);
+  Retire(node);
 }
 
-bool SimpleLRU::AddToEmptyCache(const std::string &key, const std::string &value) {
-  lru_node *temp = AddToHash(key, value);
-  if (!temp) {
+bool SimpleLRU::InsertNewNode(const std::string &key, const std::string &value, std::time_t expire_at) {
+  FreeSpace(key.size() + value.size());
+
+  lru_node *node = AllocateNode(key, value);
+  if (!_lru_index.Insert(node)) {
+    FreeNode(node);
     return false;
   }
+
+  LinkToTail(*node);
+  SetExpiration(*node, expire_at);
   _cur_size += key.size() + value.size();
-  _lru_tail = temp;
-  _lru_head.reset(_lru_tail);
   return true;
 }
 
-bool SimpleLRU::AddAnotherElem(const std::string &key, const std::string &value) {
-  lru_node *temp = AddToHash(key, value);
-  if (!temp) {
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Put(const std::string &key, const std::string &value, std::time_t expire_at) {
+  if (IsTooBigForCache(key.size(), value.size())) {
     return false;
   }
-  _cur_size += key.size() + value.size();
-  _lru_tail->next.reset(temp);
-  _lru_tail = _lru_tail->next.get();
-  return true;
-}
 
-bool SimpleLRU::InsertNewNode(const std::string &key, const std::string &value) {
-  if (_lru_head == nullptr) {
-    return AddToEmptyCache(key, value);
-  }  
-  return AddAnotherElem(key, value);
-}
+  std::time_t now = ExpireItems();
+  lru_node *node = _lru_index.Find(key);
+  if (IsExpired(expire_at, now)) {
+    // New value is stale already, the only visible effect is that the old one is gone
+    if (node != nullptr) {
+      RemoveNode(node);
+    }
+    return true;
+  }
 
-void SimpleLRU::MoveToHead(hash_map::const_iterator it) {
-  if (it->second.get().next == nullptr) {
-    return;
+  if (node == nullptr) {
+    return InsertNewNode(key, value, expire_at);
   }
-  _lru_tail->next = ExtractNode(it);
-  _lru_tail->next->prev = _lru_tail;
-  _lru_tail = _lru_tail->next.get();
+
+  MoveToTail(*node);
+  UpdateValue(node, value, expire_at);
+  return true;
 }
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Put(const std::string &key, const std::string &value) {
+bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at) {
   if (IsTooBigForCache(key.size(), value.size())) {
     return false;
   }
 
-  auto it = _lru_index.find(key);
+  std::time_t now = ExpireItems();
+  if (_lru_index.Find(key) != nullptr) {
+    return false;
+  }
 
-  if (it == _lru_index.end()) {
-    FreeSpace(key.size() + value.size());
-    return InsertNewNode(key, value);
+  if (IsExpired(expire_at, now)) {
+    return true;
   }
+  return InsertNewNode(key, value, expire_at);
+}
 
-  MoveToHead(it);
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Set(const std::string &key, const std::string &value, std::time_t expire_at) {
+  if (IsTooBigForCache(key.size(), value.size())) {
+    return false;
+  }
 
-  FreeSpace(value.size() - it->second.get().value.size());
+  std::time_t now = ExpireItems();
+  lru_node *node = _lru_index.Find(key);
+  if (node == nullptr) {
+    return false;
+  }
 
-  UpdateValue(it, value);
+  if (IsExpired(expire_at, now)) {
+    RemoveNode(node);
+    return true;
+  }
 
+  MoveToTail(*node);
+  UpdateValue(node, value, expire_at);
   return true;
 }
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value) {
-  if (IsTooBigForCache(key.size(), value.size())) {
+bool SimpleLRU::Delete(const std::string &key) {
+  ExpireItems();
+  lru_node *node = _lru_index.Find(key);
+  if (node == nullptr) {
     return false;
   }
 
-  auto it = _lru_index.find(key);
-  if (it != _lru_index.end()) {
+  RemoveNode(node);
+  return true;
+}
+
+// Memory of all nodes is dropped in bulk, unless some of them are pinned and must stay alive
+void SimpleLRU::FlushAll() {
+  if (_pinned > 0) {
+    while (_lru_head != nullptr) {
+      RemoveNode(_lru_head);
+    }
+    return;
+  }
+
+  _lru_index.Clear();
+  _timers.Clear();
+  _slabs.Reset();
+  _lru_head = _lru_tail = nullptr;
+  _cur_size = 0;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Get(const std::string &key, std::string &value) {
+  // Not a virtual call, thread safe subclasses hold their lock already
+  std::time_t expire_at;
+  return SimpleLRU::Get(key, value, expire_at);
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Get(const std::string &key, std::string &value, std::time_t &expire_at) {
+  lru_node *node = FindAlive(key);
+  if (node == nullptr) {
     return false;
   }
 
-  FreeSpace(key.size() + value.size());
-  InsertNewNode(key, value);
+  value.assign(node->value(), node->value_size);
+  expire_at = node->expire_at;
+  MoveToTail(*node);
   return true;
 }
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Set(const std::string &key, const std::string &value) {
-  if (IsTooBigForCache(key.size(), value.size())) {  // it->second.get().value.size()
+bool SimpleLRU::Pin(const std::string &key, ValueView &value) {
+  value.Reset();
+  lru_node *node = FindAlive(key);
+  if (node == nullptr) {
     return false;
   }
 
-  auto it = _lru_index.find(key);
-  if (it == _lru_index.end()) {
-    return false;
+  if (node->pins++ == 0) {
+    _pinned++;
   }
-  
-  FreeSpace(value.size() - it->second.get().value.size());
-  UpdateValue(it, value);
+  value = ValueView(node->value(), node->value_size, &SimpleLRU::ReleasePin, this, node);
+  MoveToTail(*node);
   return true;
 }
 
-// See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Delete(const std::string &key) {
-  auto it = _lru_index.find(key);
-  if (it == _lru_index.end()) {
+// See SimpleLRU.h
+bool SimpleLRU::Oldest(std::string &key) const {
+  if (_lru_head == nullptr) {
     return false;
   }
 
-  auto temp = ExtractNode(it);
-  _lru_index.erase(it);
+  key.assign(_lru_head->key(), _lru_head->key_size);
   return true;
 }
 
-// See MapBasedGlobalLockImpl.h
-
-bool SimpleLRU::Get(const std::string &key, std::string &value) {
-  auto it = _lru_index.find(key);
-  if (it == _lru_index.end()) {
+// See SimpleLRU.h
+bool SimpleLRU::PopOldest(std::string &key, std::string &value, std::time_t &expire_at) {
+  ExpireItems();
+  if (_lru_head == nullptr) {
     return false;
   }
 
-  value = it->second.get().value;
-  MoveToHead(it);
+  lru_node *node = _lru_head;
+  key.assign(node->key(), node->key_size);
+  value.assign(node->value(), node->value_size);
+  expire_at = node->expire_at;
+  RemoveNode(node);
   return true;
 }
 
+void SimpleLRU::Unpin(void *item) {
+  lru_node *node = static_cast<lru_node *>(item);
+  if (--node->pins > 0) {
+    return;
+  }
+
+  _pinned--;
+  if (node->zombie) {
+    FreeNode(node);
+  }
+}
+
 } // namespace Backend
 } // namespace Afina
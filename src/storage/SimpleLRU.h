@@ -1,88 +1,166 @@
 #ifndef AFINA_STORAGE_SIMPLE_LRU_H
 #define AFINA_STORAGE_SIMPLE_LRU_H
 
-#include <map>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
 
 #include <afina/Storage.h>
 
+#include "HashIndex.h"
+#include "SlabAllocator.h"
+#include "TimerWheel.h"
+
 namespace Afina {
 namespace Backend {
 
 /**
- * # Map based implementation
+ * # Hash index based implementation
+ * Expired items are rejected lazily on read and reclaimed by the timer wheel on every
+ * modification, so they never push live items out of the cache.
+ *
  * That is NOT thread safe implementaiton!!
  */
 class SimpleLRU : public Afina::Storage {
 public:
-    SimpleLRU(size_t max_size = 1024) : _max_size(max_size) {}
-
-    ~SimpleLRU() {
-        _lru_index.clear();
-        // TODO: Here is stack overflow
-        while (_lru_head) {
-            auto temp = move(_lru_head->next);
-            _lru_head = move(temp);
-        }
-    }
+    SimpleLRU(size_t max_size = 1024);
+    ~SimpleLRU();
 
     // Implements Afina::Storage interface
-    bool Put(const std::string &key, const std::string &value) override;
+    bool Put(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
 
     // Implements Afina::Storage interface
-    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
 
     // Implements Afina::Storage interface
-    bool Set(const std::string &key, const std::string &value) override;
+    bool Set(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
 
     // Implements Afina::Storage interface
     bool Delete(const std::string &key) override;
 
+    // Implements Afina::Storage interface
+    void FlushAll() override;
+
     // Implements Afina::Storage interface
     bool Get(const std::string &key, std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::time_t &expire_at) override;
+
+    // Implements Afina::Storage interface
+    bool Pin(const std::string &key, ValueView &value) override;
+
+    /**
+     * Number of bytes taken by keys and values
+     */
+    inline size_t Size() const { return _cur_size; }
+
+    /**
+     * Memory budget for keys and values
+     */
+    inline size_t MaxSize() const { return _max_size; }
+
+    /**
+     * Returns key of the least recently used item, that is the one to be evicted next. Item is not
+     * touched, so its position doesn't change
+     */
+    bool Oldest(std::string &key) const;
+
+    /**
+     * Removes the least recently used item from the cache and returns it
+     */
+    bool PopOldest(std::string &key, std::string &value, std::time_t &expire_at);
+
+protected:
+    /**
+     * Called once view created by Pin gets released
+     */
+    virtual void Unpin(void *item);
 
 private:
-    // LRU cache node
-    using lru_node = struct lru_node {
-        const std::string key;
-        std::string value;
+    // LRU cache node. Each node is a single slab chunk: header below is followed by the key
+    // bytes and then by the value bytes. Node with expiration time is kept in the timer wheel
+    struct lru_node : public TimerWheel::Entry {
         lru_node *prev;
-        std::unique_ptr<lru_node> next;
+        lru_node *next;
+        uint32_t key_size;
+        uint32_t value_size;
+
+        // Slab class of the chunk node lives in
+        uint8_t slab_class;
+
+        // Node was removed from the cache while pinned, memory is released with the last pin
+        bool zombie;
+
+        // Number of alive views on the value
+        uint32_t pins;
+
+        inline char *key() { return reinterpret_cast<char *>(this + 1); }
+        inline const char *key() const { return reinterpret_cast<const char *>(this + 1); }
+        inline char *value() { return key() + key_size; }
+        inline const char *value() const { return key() + key_size; }
     };
 
-    using hash_map = std::map<const std::reference_wrapper<const std::string>, std::reference_wrapper<lru_node>, std::less<std::string>>;    
+    // Key of the node for the index
+    struct lru_key {
+        struct view {
+            const char *ptr;
+            size_t len;
+            inline const char *data() const { return ptr; }
+            inline size_t size() const { return len; }
+        };
+
+        view operator()(const lru_node &node) const { return view{node.key(), node.key_size}; }
+    };
+
+    using hash_map = HashIndex<lru_node, lru_key>;
 
     // Maximum number of bytes could be stored in this cache.
     // i.e all (keys+values) must be not greater than the _max_size
     std::size_t _max_size;
     std::size_t _cur_size = 0;
 
+    // Memory for all nodes
+    SlabAllocator _slabs;
+
     // Main storage of lru_nodes, elements in this list ordered descending by "freshness": in the head
     // element that wasn't used for longest time.
-    //
-    // List owns all nodes
-    std::unique_ptr<lru_node> _lru_head;
+    lru_node *_lru_head = nullptr;
     lru_node *_lru_tail = nullptr;
 
     // Index of nodes from list above, allows fast random access to elements by lru_node#key
     hash_map _lru_index;
 
+    // Nodes having expiration time
+    TimerWheel _timers;
+
+    // Number of nodes having alive views, including removed ones
+    size_t _pinned = 0;
+
 private:
-    std::unique_ptr<lru_node> ExtractHead();
-    std::unique_ptr<lru_node> ExtractTail();
-    std::unique_ptr<lru_node> ExtractNode(hash_map::const_iterator it);
-    void MoveToHead(hash_map::const_iterator it);
-    
-    lru_node* AddToHash(const std::string &key, const std::string &value);
-    bool AddToEmptyCache(const std::string &key, const std::string &value);
-    bool AddAnotherElem(const std::string &key, const std::string &value);
-    bool InsertNewNode(const std::string &key, const std::string &value);
+    static void ReleasePin(void *owner, void *item) { static_cast<SimpleLRU *>(owner)->Unpin(item); }
+
+    lru_node *AllocateNode(const std::string &key, const std::string &value);
+    void FreeNode(lru_node *node);
+    void Retire(lru_node *node);
+    void RemoveNode(lru_node *node);
+
+    void Unlink(lru_node &node);
+    void LinkToTail(lru_node &node);
+    void MoveToTail(lru_node &node);
+
+    bool InsertNewNode(const std::string &key, const std::string &value, std::time_t expire_at);
     bool IsTooBigForCache(size_t key_size, size_t value_size);
-    void FreeSpace(int delta_space);
-    void UpdateValue(hash_map::const_iterator it, const std::string &value);
+    void FreeSpace(size_t required);
+    void UpdateValue(lru_node *node, const std::string &value, std::time_t expire_at);
+    void SetExpiration(lru_node &node, std::time_t expire_at);
+
+    // Drops all items expired by now, returns current time
+    std::time_t ExpireItems();
+
+    // Finds item which is not expired yet, expired one is dropped right away
+    lru_node *FindAlive(const std::string &key);
 };
 
 } // namespace Backend
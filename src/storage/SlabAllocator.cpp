@@ -0,0 +1,128 @@
+#include "SlabAllocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+// All chunks are aligned on the pointer size
+inline size_t Align(size_t size) { return (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1); }
+
+} // namespace
+
+// See SlabAllocator.h
+SlabAllocator::SlabAllocator(size_t page_size, double growth_factor, size_t min_chunk)
+    : _pages_used(0), _large(nullptr), _page_size(Align(page_size)) {
+    if (growth_factor <= 1.0) {
+        throw std::invalid_argument("Slab growth factor must be greater than 1");
+    }
+
+    size_t size = Align(std::max(min_chunk, sizeof(free_chunk)));
+    while (size < _page_size && _classes.size() < kLargeClass - 1) {
+        _classes.push_back(slab_class{size, nullptr, nullptr, nullptr});
+        size = std::max(size + sizeof(void *), Align(size_t(size * growth_factor)));
+    }
+    _classes.push_back(slab_class{_page_size, nullptr, nullptr, nullptr});
+}
+
+// See SlabAllocator.h
+SlabAllocator::~SlabAllocator() {
+    Reset();
+    for (char *page : _pages) {
+        std::free(page);
+    }
+}
+
+// See SlabAllocator.h
+void *SlabAllocator::Allocate(size_t size, uint8_t &cls) {
+    auto it = std::lower_bound(_classes.begin(), _classes.end(), size,
+                               [](const slab_class &c, size_t size) { return c.chunk_size < size; });
+
+    if (it == _classes.end()) {
+        large_chunk *chunk = static_cast<large_chunk *>(std::malloc(sizeof(large_chunk) + size));
+        if (chunk == nullptr) {
+            throw std::bad_alloc();
+        }
+
+        chunk->prev = nullptr;
+        chunk->next = _large;
+        if (_large != nullptr) {
+            _large->prev = chunk;
+        }
+        _large = chunk;
+
+        cls = kLargeClass;
+        return chunk + 1;
+    }
+
+    slab_class &c = *it;
+    cls = uint8_t(it - _classes.begin());
+
+    if (c.free_list != nullptr) {
+        free_chunk *chunk = c.free_list;
+        c.free_list = chunk->next;
+        return chunk;
+    }
+
+    if (size_t(c.page_end - c.page_pos) < c.chunk_size) {
+        if (_pages_used == _pages.size()) {
+            char *page = static_cast<char *>(std::malloc(_page_size));
+            if (page == nullptr) {
+                throw std::bad_alloc();
+            }
+            _pages.push_back(page);
+        }
+
+        char *page = _pages[_pages_used++];
+        c.page_pos = page;
+        c.page_end = page + _page_size;
+    }
+
+    void *result = c.page_pos;
+    c.page_pos += c.chunk_size;
+    return result;
+}
+
+// See SlabAllocator.h
+void SlabAllocator::Reset() {
+    for (auto &c : _classes) {
+        c.free_list = nullptr;
+        c.page_pos = c.page_end = nullptr;
+    }
+    _pages_used = 0;
+
+    while (_large != nullptr) {
+        large_chunk *next = _large->next;
+        std::free(_large);
+        _large = next;
+    }
+}
+
+// See SlabAllocator.h
+void SlabAllocator::Free(void *p, uint8_t cls) {
+    if (cls == kLargeClass) {
+        large_chunk *chunk = static_cast<large_chunk *>(p) - 1;
+        if (chunk->prev != nullptr) {
+            chunk->prev->next = chunk->next;
+        } else {
+            _large = chunk->next;
+        }
+        if (chunk->next != nullptr) {
+            chunk->next->prev = chunk->prev;
+        }
+        std::free(chunk);
+        return;
+    }
+
+    free_chunk *chunk = static_cast<free_chunk *>(p);
+    chunk->next = _classes[cls].free_list;
+    _classes[cls].free_list = chunk;
+}
+
+} // namespace Backend
+} // namespace Afina
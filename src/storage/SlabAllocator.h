@@ -0,0 +1,106 @@
+#ifndef AFINA_STORAGE_SLAB_ALLOCATOR_H
+#define AFINA_STORAGE_SLAB_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Memcached style slab allocator
+ * Memory is requested from the system by pages of fixed size. Each page belongs to a single size
+ * class and is cut into chunks of that class size, class sizes grows geometrically from the
+ * smallest one up to the page size. Allocation takes chunk of the smallest class that fits the
+ * requested size from the class free list, so it is O(1) and doesn't touch system allocator
+ * unless new page is required. Freed chunk goes back to the free list of its class.
+ *
+ * Pages are never returned to the system until allocator gets destroyed. Requests which are
+ * bigger than a page are served by the system allocator directly.
+ *
+ * All chunks could be dropped at once by Reset, that only rewinds classes and keeps pages to be
+ * handed out again, so its cost depends on number of classes rather than number of chunks.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class SlabAllocator {
+public:
+    // Class of the chunks allocated directly from the system
+    static const uint8_t kLargeClass = 0xff;
+
+    SlabAllocator(size_t page_size = 1024 * 1024, double growth_factor = 1.25, size_t min_chunk = 64);
+    ~SlabAllocator();
+
+    /**
+     * Allocates chunk that could hold at least size bytes. Class of the allocated chunk is
+     * written to the output parameter, it must be passed back on Free
+     *
+     * Throws std::bad_alloc if system runs out of memory
+     */
+    void *Allocate(size_t size, uint8_t &slab_class);
+
+    /**
+     * Returns chunk to the free list of its class
+     */
+    void Free(void *chunk, uint8_t slab_class);
+
+    /**
+     * Releases all chunks allocated so far at once, all pointers returned before become invalid
+     */
+    void Reset();
+
+    /**
+     * Number of bytes that could be used in the chunk of the given class
+     */
+    size_t ChunkSize(uint8_t slab_class, size_t size) const {
+        return slab_class == kLargeClass ? size : _classes[slab_class].chunk_size;
+    }
+
+private:
+    SlabAllocator(const SlabAllocator &) = delete;
+    SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+    // Header of the freed chunk
+    struct free_chunk {
+        free_chunk *next;
+    };
+
+    // Header of the chunk allocated from the system directly
+    struct large_chunk {
+        large_chunk *prev;
+        large_chunk *next;
+    };
+
+    struct slab_class {
+        // Size of every chunk in the class
+        size_t chunk_size;
+
+        // Chunks that were freed and could be reused
+        free_chunk *free_list;
+
+        // Unused tail of the last page allocated for the class
+        char *page_pos;
+        char *page_end;
+    };
+
+    // Chunk size of each class
+    std::vector<slab_class> _classes;
+
+    // All pages allocated so far
+    std::vector<char *> _pages;
+
+    // Number of pages given to the classes, the rest are left after Reset and wait for reuse
+    size_t _pages_used;
+
+    // List of chunks allocated from the system directly
+    large_chunk *_large;
+
+    // Size of page requested from the system
+    const size_t _page_size;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SLAB_ALLOCATOR_H
@@ -0,0 +1,98 @@
+#ifndef AFINA_STORAGE_STRIPED_LRU_H
+#define AFINA_STORAGE_STRIPED_LRU_H
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "ThreadSafeSimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Striped SimpleLRU
+ * Keys are spread by hash over a number of independent ThreadSafeSimplLRU shards, each one has
+ * its own lock and its own part of the memory budget. Operations on keys that belong to different
+ * stripes never contend with each other.
+ *
+ * Note that LRU order is maintained per stripe only, so eviction is "approximate" LRU for the
+ * storage as a whole. Also, a single key/value pair must fit into one stripe budget
+ */
+class StripedLRU : public Afina::Storage {
+public:
+    StripedLRU(size_t max_size = 1024, size_t stripe_count = 4) {
+        if (stripe_count == 0) {
+            throw std::invalid_argument("Stripes count must be positive");
+        }
+        if (max_size < stripe_count) {
+            throw std::invalid_argument("Storage is too small for the given stripes count");
+        }
+
+        // Budget of stripes sums exactly to max_size, first stripes take the remainder
+        _stripes.reserve(stripe_count);
+        for (size_t i = 0; i < stripe_count; i++) {
+            size_t stripe_size = max_size / stripe_count + (i < max_size % stripe_count ? 1 : 0);
+            _stripes.emplace_back(new ThreadSafeSimplLRU(stripe_size));
+        }
+    }
+
+    ~StripedLRU() {}
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
+        return Stripe(key).Put(key, value, expire_at);
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
+        return Stripe(key).PutIfAbsent(key, value, expire_at);
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
+        return Stripe(key).Set(key, value, expire_at);
+    }
+
+    // see SimpleLRU.h
+    bool Delete(const std::string &key) override { return Stripe(key).Delete(key); }
+
+    // see SimpleLRU.h
+    void FlushAll() override {
+        for (auto &stripe : _stripes) {
+            stripe->FlushAll();
+        }
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value) override { return Stripe(key).Get(key, value); }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value, std::time_t &expire_at) override {
+        return Stripe(key).Get(key, value, expire_at);
+    }
+
+    // see SimpleLRU.h
+    bool Pin(const std::string &key, ValueView &value) override {
+        // Previous value could belong to another stripe, it is released before any lock is taken
+        value.Reset();
+        return Stripe(key).Pin(key, value);
+    }
+
+private:
+    ThreadSafeSimplLRU &Stripe(const std::string &key) {
+        return *_stripes[std::hash<std::string>()(key) % _stripes.size()];
+    }
+
+    // Independent shards, each protected by its own lock
+    std::vector<std::unique_ptr<ThreadSafeSimplLRU>> _stripes;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_STRIPED_LRU_H
@@ -21,21 +21,21 @@ public:
     ~ThreadSafeSimplLRU() {}
 
     // see SimpleLRU.h
-    bool Put(const std::string &key, const std::string &value) override {
+    bool Put(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
         std::lock_guard<std::mutex> guard(m);
-        return SimpleLRU::Put(key, value);
+        return SimpleLRU::Put(key, value, expire_at);
     }
 
     // see SimpleLRU.h
-    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
         std::lock_guard<std::mutex> guard(m);
-        return SimpleLRU::PutIfAbsent(key, value);
+        return SimpleLRU::PutIfAbsent(key, value, expire_at);
     }
 
     // see SimpleLRU.h
-    bool Set(const std::string &key, const std::string &value) override {
+    bool Set(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
         std::lock_guard<std::mutex> guard(m);
-        return SimpleLRU::Set(key, value);
+        return SimpleLRU::Set(key, value, expire_at);
     }
 
     // see SimpleLRU.h
@@ -44,12 +44,40 @@ public:
         return SimpleLRU::Delete(key);
     }
 
+    // see SimpleLRU.h
+    void FlushAll() override {
+        std::lock_guard<std::mutex> guard(m);
+        SimpleLRU::FlushAll();
+    }
+
     // see SimpleLRU.h
     bool Get(const std::string &key, std::string &value) override {
         std::lock_guard<std::mutex> guard(m);
         return SimpleLRU::Get(key, value);
     }
 
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value, std::time_t &expire_at) override {
+        std::lock_guard<std::mutex> guard(m);
+        return SimpleLRU::Get(key, value, expire_at);
+    }
+
+    // see SimpleLRU.h
+    bool Pin(const std::string &key, ValueView &value) override {
+        // Releasing previous value calls Unpin, which takes the lock as well
+        value.Reset();
+
+        std::lock_guard<std::mutex> guard(m);
+        return SimpleLRU::Pin(key, value);
+    }
+
+protected:
+    // see SimpleLRU.h
+    void Unpin(void *item) override {
+        std::lock_guard<std::mutex> guard(m);
+        SimpleLRU::Unpin(item);
+    }
+
 private:
     std::mutex m;
 };
@@ -0,0 +1,75 @@
+#ifndef AFINA_STORAGE_THREAD_SAFE_TINY_LFU_H
+#define AFINA_STORAGE_THREAD_SAFE_TINY_LFU_H
+
+#include <mutex>
+#include <string>
+
+#include "TinyLFU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # TinyLFU thread safe version
+ *
+ *
+ */
+class ThreadSafeTinyLFU : public TinyLFU {
+public:
+    ThreadSafeTinyLFU(size_t max_size = 1024, size_t window_percent = 1) : TinyLFU(max_size, window_percent) {}
+    ~ThreadSafeTinyLFU() {}
+
+    // see TinyLFU.h
+    bool Put(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
+        std::lock_guard<std::mutex> guard(m);
+        return TinyLFU::Put(key, value, expire_at);
+    }
+
+    // see TinyLFU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
+        std::lock_guard<std::mutex> guard(m);
+        return TinyLFU::PutIfAbsent(key, value, expire_at);
+    }
+
+    // see TinyLFU.h
+    bool Set(const std::string &key, const std::string &value, std::time_t expire_at = 0) override {
+        std::lock_guard<std::mutex> guard(m);
+        return TinyLFU::Set(key, value, expire_at);
+    }
+
+    // see TinyLFU.h
+    bool Delete(const std::string &key) override {
+        std::lock_guard<std::mutex> guard(m);
+        return TinyLFU::Delete(key);
+    }
+
+    // see TinyLFU.h
+    void FlushAll() override {
+        std::lock_guard<std::mutex> guard(m);
+        TinyLFU::FlushAll();
+    }
+
+    // see TinyLFU.h
+    bool Get(const std::string &key, std::string &value) override {
+        std::lock_guard<std::mutex> guard(m);
+        return TinyLFU::Get(key, value);
+    }
+
+    // see TinyLFU.h
+    bool Get(const std::string &key, std::string &value, std::time_t &expire_at) override {
+        std::lock_guard<std::mutex> guard(m);
+        return TinyLFU::Get(key, value, expire_at);
+    }
+
+    // Views of TinyLFU are released by its segments which know nothing about the lock here, so value
+    // is copied instead
+    bool Pin(const std::string &key, ValueView &value) override { return Storage::Pin(key, value); }
+
+private:
+    std::mutex m;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_THREAD_SAFE_TINY_LFU_H
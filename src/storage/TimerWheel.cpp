@@ -0,0 +1,92 @@
+#include "TimerWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+inline void MakeEmpty(TimerWheel::Entry &slot) { slot.prev_timer = slot.next_timer = &slot; }
+
+} // namespace
+
+// See TimerWheel.h
+TimerWheel::TimerWheel(std::time_t now) : _current(now), _size(0) {
+    for (auto &level : _wheel) {
+        for (auto &slot : level) {
+            MakeEmpty(slot);
+        }
+    }
+}
+
+// See TimerWheel.h
+void TimerWheel::Schedule(Entry &entry) { Link(Slot(entry.expire_at), entry); }
+
+// See TimerWheel.h
+void TimerWheel::Cancel(Entry &entry) {
+    if (entry.next_timer == nullptr) {
+        return;
+    }
+
+    entry.prev_timer->next_timer = entry.next_timer;
+    entry.next_timer->prev_timer = entry.prev_timer;
+    entry.prev_timer = entry.next_timer = nullptr;
+    _size--;
+}
+
+// See TimerWheel.h
+void TimerWheel::Clear() {
+    for (auto &level : _wheel) {
+        for (auto &slot : level) {
+            MakeEmpty(slot);
+        }
+    }
+    _size = 0;
+}
+
+void TimerWheel::Link(Entry &slot, Entry &entry) {
+    entry.prev_timer = &slot;
+    entry.next_timer = slot.next_timer;
+    slot.next_timer->prev_timer = &entry;
+    slot.next_timer = &entry;
+    _size++;
+}
+
+// Called once wheel is turned to the new second, entries expiring right now must go to the slot
+// which is about to fire
+void TimerWheel::Cascade(Entry &slot) {
+    Entry *entry = slot.next_timer;
+    MakeEmpty(slot);
+    while (entry != &slot) {
+        Entry *next = entry->next_timer;
+        _size--;
+        if (entry->expire_at <= _current) {
+            Link(_wheel[0][_current & kSlotMask], *entry);
+        } else {
+            Schedule(*entry);
+        }
+        entry = next;
+    }
+}
+
+TimerWheel::Entry &TimerWheel::Slot(std::time_t expire_at) {
+    std::time_t delta = expire_at - _current;
+    if (delta <= 0) {
+        // Already expired, fire on the next tick
+        return _wheel[0][(_current + 1) & kSlotMask];
+    }
+
+    for (size_t level = 0; level < kLevels; level++) {
+        std::time_t level_span = std::time_t(1) << ((level + 1) * kSlotBits);
+        if (delta < level_span) {
+            return _wheel[level][(expire_at >> (level * kSlotBits)) & kSlotMask];
+        }
+    }
+
+    // Too far in future, park at the most distant slot, entry gets rescheduled once it is reached
+    size_t top = kLevels - 1;
+    std::time_t parked = _current + (std::time_t(1) << (kLevels * kSlotBits)) - 1;
+    return _wheel[top][(parked >> (top * kSlotBits)) & kSlotMask];
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,120 @@
+#ifndef AFINA_STORAGE_TIMER_WHEEL_H
+#define AFINA_STORAGE_TIMER_WHEEL_H
+
+#include <array>
+#include <cstddef>
+#include <ctime>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Hierarchical timer wheel
+ * Tracks expiration time of items with one second resolution. Wheel consists of several levels,
+ * each of 64 slots. Slot of the first level covers one second, slot of each next level covers
+ * whole previous level. Timer is placed into the slot of the lowest level that covers its
+ * expiration time, when wheel turns to the slot of upper level its timers get cascaded down.
+ *
+ * Schedule and cancel are O(1), each timer is cascaded at most once per level, so overall cost
+ * of expiration is O(1) per item and doesn't depend on number of items.
+ *
+ * Timers are intrusive: item that could expire must inherit Entry. Each slot is a circular list
+ * with sentinel head, so entry could be removed without knowing which slot it is in.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class TimerWheel {
+public:
+    struct Entry {
+        Entry *prev_timer = nullptr;
+        Entry *next_timer = nullptr;
+
+        // Absolute time in seconds since epoch when item expires, 0 means never
+        std::time_t expire_at = 0;
+    };
+
+    TimerWheel(std::time_t now);
+
+    /**
+     * Place entry into the wheel according to its expire_at, which must not be 0. If entry is
+     * already expired it is fired on the next Advance
+     */
+    void Schedule(Entry &entry);
+
+    /**
+     * Remove entry from the wheel, it does nothing if entry isn't scheduled
+     */
+    void Cancel(Entry &entry);
+
+    /**
+     * Turn wheel up to the given time. Callback is called for every entry which has expired by that
+     * time, entry is already removed from the wheel at that point, so callback is free to destroy it
+     */
+    template <typename F> void Advance(std::time_t now, F on_expired) {
+        while (_current < now) {
+            if (_size == 0) {
+                _current = now;
+                return;
+            }
+
+            _current++;
+            size_t index = _current & kSlotMask;
+            if (index == 0) {
+                for (size_t level = 1; level < kLevels; level++) {
+                    size_t level_index = (_current >> (level * kSlotBits)) & kSlotMask;
+                    Cascade(_wheel[level][level_index]);
+                    if (level_index != 0) {
+                        break;
+                    }
+                }
+            }
+
+            Entry &slot = _wheel[0][index];
+            while (slot.next_timer != &slot) {
+                Entry *entry = slot.next_timer;
+                Cancel(*entry);
+                on_expired(entry);
+            }
+        }
+    }
+
+    /**
+     * Drop all timers at once. Entries are not touched, so they must not be used with the wheel
+     * anymore, that is for the case when all of them are about to be destroyed
+     */
+    void Clear();
+
+    inline std::size_t Size() const { return _size; }
+
+private:
+    static const size_t kLevels = 5;
+    static const size_t kSlotBits = 6;
+    static const size_t kSlots = 1 << kSlotBits;
+    static const size_t kSlotMask = kSlots - 1;
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    // Adds entry to the slot list
+    void Link(Entry &slot, Entry &entry);
+
+    // Re-schedule all entries from the given slot
+    void Cascade(Entry &slot);
+
+    // Finds slot entry expiring at the given time belongs to
+    Entry &Slot(std::time_t expire_at);
+
+    // Time wheel was turned to, all entries expired by this time have been fired
+    std::time_t _current;
+
+    // Number of scheduled entries
+    std::size_t _size;
+
+    // Sentinels of the slot lists
+    std::array<std::array<Entry, kSlots>, kLevels> _wheel;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TIMER_WHEEL_H
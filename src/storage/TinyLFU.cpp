@@ -0,0 +1,159 @@
+#include "TinyLFU.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <afina/Counters.h>
+
+#include "HashIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+// Sketch is sized by number of items, expect them to be small
+const size_t kAverageItemSize = 64;
+
+// Window smaller than a few items is useless: new keys skip it, lose to the main LRU victim on
+// the first access and never build up frequency
+const size_t kMinWindowItems = 4;
+
+// Floor never takes more than a half of the budget, so small caches are still mostly main LRU
+size_t WindowSize(size_t max_size, size_t window_percent) {
+    return std::max(max_size * window_percent / 100, std::min(kMinWindowItems * kAverageItemSize, max_size / 2));
+}
+
+} // namespace
+
+// See TinyLFU.h
+TinyLFU::TinyLFU(size_t max_size, size_t window_percent)
+    : _window(WindowSize(max_size, window_percent)), _main(max_size - WindowSize(max_size, window_percent)),
+      _sketch(max_size / kAverageItemSize) {
+    if (window_percent >= 100) {
+        throw std::invalid_argument("Window must be smaller than the whole cache");
+    }
+}
+
+void TinyLFU::Touch(const std::string &key) { _sketch.Increment(HashBytes(key.data(), key.size())); }
+
+uint32_t TinyLFU::Frequency(const std::string &key) const {
+    return _sketch.Estimate(HashBytes(key.data(), key.size()));
+}
+
+bool TinyLFU::Update(const std::string &key, const std::string &value, std::time_t expire_at, bool &stored) {
+    stored = true;
+    if (_main.Set(key, value, expire_at)) {
+        return true;
+    }
+
+    // Item is placed in the window again, so that items window evicts to make room for a bigger value
+    // go to admission rather than disappear, and too big value goes to admission right away
+    if (!_window.Delete(key)) {
+        return false;
+    }
+    stored = Insert(key, value, expire_at);
+    return true;
+}
+
+bool TinyLFU::Insert(const std::string &key, const std::string &value, std::time_t expire_at) {
+    if (expire_at != 0 && expire_at <= std::time(nullptr)) {
+        return true;
+    }
+
+    size_t size = key.size() + value.size();
+    if (size > _window.MaxSize()) {
+        return Admit(key, value, expire_at);
+    }
+
+    std::string candidate_key, candidate_value;
+    std::time_t candidate_expire_at;
+    while (_window.Size() + size > _window.MaxSize() &&
+           _window.PopOldest(candidate_key, candidate_value, candidate_expire_at)) {
+        Admit(candidate_key, candidate_value, candidate_expire_at);
+    }
+    return _window.Put(key, value, expire_at);
+}
+
+// Candidate is compared with the first victim only, even if it takes several evictions to make
+// room for it. Ties are resolved in favor of the victim, so that cold keys don't churn main LRU
+bool TinyLFU::Admit(const std::string &key, const std::string &value, std::time_t expire_at) {
+    if (_main.Size() + key.size() + value.size() > _main.MaxSize()) {
+        std::string victim;
+        if (_main.Oldest(victim) && Frequency(key) <= Frequency(victim)) {
+            // Candidate leaves the cache instead of the victim, which is an eviction as well
+            LocalCounters().evictions.Add();
+            return false;
+        }
+    }
+    return _main.Put(key, value, expire_at);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Put(const std::string &key, const std::string &value, std::time_t expire_at) {
+    if (IsTooBigForCache(key.size(), value.size())) {
+        return false;
+    }
+
+    Touch(key);
+    bool stored;
+    if (Update(key, value, expire_at, stored)) {
+        return stored;
+    }
+    return Insert(key, value, expire_at);
+}
+
+// See TinyLFU.h
+bool TinyLFU::PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at) {
+    if (IsTooBigForCache(key.size(), value.size())) {
+        return false;
+    }
+
+    Touch(key);
+    ValueView existing;
+    if (_window.Pin(key, existing) || _main.Pin(key, existing)) {
+        return false;
+    }
+    return Insert(key, value, expire_at);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Set(const std::string &key, const std::string &value, std::time_t expire_at) {
+    if (IsTooBigForCache(key.size(), value.size())) {
+        return false;
+    }
+
+    Touch(key);
+    bool stored;
+    return Update(key, value, expire_at, stored) && stored;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Delete(const std::string &key) { return _window.Delete(key) || _main.Delete(key); }
+
+// Access history in the sketch stays, it is still valid for keys that will come back
+void TinyLFU::FlushAll() {
+    _window.FlushAll();
+    _main.FlushAll();
+}
+
+// See TinyLFU.h
+bool TinyLFU::Get(const std::string &key, std::string &value) {
+    Touch(key);
+    return _window.Get(key, value) || _main.Get(key, value);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Get(const std::string &key, std::string &value, std::time_t &expire_at) {
+    Touch(key);
+    return _window.Get(key, value, expire_at) || _main.Get(key, value, expire_at);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Pin(const std::string &key, ValueView &value) {
+    Touch(key);
+    return _window.Pin(key, value) || _main.Pin(key, value);
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,97 @@
+#ifndef AFINA_STORAGE_TINY_LFU_H
+#define AFINA_STORAGE_TINY_LFU_H
+
+#include <ctime>
+#include <string>
+
+#include <afina/Storage.h>
+
+#include "FrequencySketch.h"
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # W-TinyLFU cache
+ * New items go to a small LRU admission window first. Item evicted from the window is admitted
+ * to the main LRU only if it is accessed more frequently than the item main LRU would evict for
+ * it, otherwise it is dropped. Frequency is estimated by count-min sketch that counts all
+ * accesses, including ones to keys which are not in the cache anymore.
+ *
+ * So a scan over cold keys passes through the window only and doesn't flush frequently used
+ * items, while the window lets new items build up frequency and handles bursts.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class TinyLFU : public Afina::Storage {
+public:
+    /**
+     * @param max_size memory budget for keys and values
+     * @param window_percent share of the budget given to the admission window, it is raised for
+     * small budgets so that window holds at least a few items
+     */
+    TinyLFU(size_t max_size = 1024, size_t window_percent = 1);
+    ~TinyLFU() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, std::time_t expire_at = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    void FlushAll() override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, std::time_t &expire_at) override;
+
+    // Implements Afina::Storage interface
+    bool Pin(const std::string &key, ValueView &value) override;
+
+private:
+    TinyLFU(const TinyLFU &) = delete;
+    TinyLFU &operator=(const TinyLFU &) = delete;
+
+    bool IsTooBigForCache(size_t key_size, size_t value_size) const {
+        return key_size + value_size > _main.MaxSize();
+    }
+
+    // Counts access to the key
+    void Touch(const std::string &key);
+    uint32_t Frequency(const std::string &key) const;
+
+    // Updates existing item, returns false if there is no such key. Window item is inserted again,
+    // stored is false if it ended up in admission and was rejected, so it is gone
+    bool Update(const std::string &key, const std::string &value, std::time_t expire_at, bool &stored);
+
+    // Puts new item into the window, items window evicts for it go to admission. Returns false if
+    // the item itself was rejected by admission
+    bool Insert(const std::string &key, const std::string &value, std::time_t expire_at);
+
+    // Puts candidate to the main LRU if it is more valuable than the main LRU victim, returns false
+    // if candidate is dropped instead
+    bool Admit(const std::string &key, const std::string &value, std::time_t expire_at);
+
+    // Admission window
+    SimpleLRU _window;
+
+    // Main cache, contains items which passed admission
+    SimpleLRU _main;
+
+    FrequencySketch _sketch;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TINY_LFU_H
@@ -322,3 +322,36 @@ TEST(SimpleTest, ReallocGrow) {
     a.free(p);
     a.free(p2);
 }
+
+TEST(SimpleTest, AvailableAfterFree) {
+    Simple a(buf, sizeof(buf));
+
+    vector<Pointer> ptrs;
+    int size = 135;
+
+    ASSERT_TRUE(fillUp(a, size, ptrs));
+    EXPECT_LT(a.available(), Simple::footprint(size));
+
+    a.free(ptrs[1]);
+    a.free(ptrs[10]);
+    a.free(ptrs[15]);
+
+    // Holes are counted even though none of them is big enough
+    size_t available = a.available();
+    EXPECT_GE(available, Simple::footprint(size * 2));
+
+    a.defrag();
+    EXPECT_EQ(available, a.available());
+
+    Pointer p = a.alloc(size * 2);
+    EXPECT_EQ(available - Simple::footprint(size * 2) + sizeof(void *), a.available());
+
+    a.realloc(p, size);
+    EXPECT_EQ(available - Simple::footprint(size) + sizeof(void *), a.available());
+
+    a.free(p);
+    EXPECT_EQ(available, a.available());
+    for (Pointer &p : ptrs) {
+        a.free(p);
+    }
+}
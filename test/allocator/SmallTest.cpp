@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/Small.h>
+
+#include "allocator/Arena.h"
+#include "allocator/Mempool.h"
+#include "allocator/SlabCache.h"
+
+using namespace std;
+using namespace Afina::Allocator;
+
+TEST(SmallTest, ArenaReusesSlabs) {
+    Arena arena(64 * 1024, 4);
+
+    set<void *> slabs;
+    for (int i = 0; i < 10; i++) {
+        void *slab = arena.Map();
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(slab) % arena.SlabSize());
+        memset(slab, 0xff, arena.SlabSize());
+        slabs.insert(slab);
+    }
+    EXPECT_EQ(10, slabs.size());
+
+    for (void *slab : slabs) {
+        arena.Unmap(slab);
+    }
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(1, slabs.count(arena.Map()));
+    }
+}
+
+TEST(SmallTest, MempoolAllocFree) {
+    Arena arena;
+    SlabCache cache(arena);
+    Mempool pool(cache, 100);
+    EXPECT_EQ(112, pool.ObjectSize());
+
+    vector<void *> objects;
+    for (int i = 0; i < 2000; i++) {
+        objects.push_back(pool.Alloc());
+        memset(objects.back(), i % 256, pool.ObjectSize());
+    }
+    EXPECT_EQ(4, pool.Slabs());
+    EXPECT_EQ(objects.size(), set<void *>(objects.begin(), objects.end()).size());
+
+    for (size_t i = 0; i < objects.size(); i++) {
+        EXPECT_EQ(char(i % 256), static_cast<char *>(objects[i])[pool.ObjectSize() - 1]);
+        EXPECT_EQ(&pool, Mempool::Owner(objects[i], arena.SlabSize()));
+        pool.Free(objects[i]);
+    }
+    EXPECT_EQ(1, pool.Slabs());
+
+    pool.Trim();
+    EXPECT_EQ(0, pool.Slabs());
+}
+
+TEST(SmallTest, MempoolAligned) {
+    Arena arena;
+    SlabCache cache(arena);
+    for (int i = 0; i < 10; i++) {
+        unique_ptr<Mempool> pool(new Mempool(cache, 16));
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pool.get()) % 64);
+    }
+}
+
+TEST(SmallTest, MempoolRemoteFree) {
+    Arena arena;
+    SlabCache cache(arena);
+    Mempool pool(cache, 64);
+
+    vector<void *> objects;
+    for (int i = 0; i < 5000; i++) {
+        objects.push_back(pool.Alloc());
+    }
+    size_t slabs = pool.Slabs();
+
+    vector<thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&objects, &pool, t]() {
+            for (size_t i = t; i < objects.size(); i += 4) {
+                pool.FreeRemote(objects[i]);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    // Objects freed by other threads are collected, so the same number of slabs is enough
+    for (size_t i = 0; i < objects.size(); i++) {
+        objects[i] = pool.Alloc();
+    }
+    EXPECT_EQ(slabs, pool.Slabs());
+
+    for (void *object : objects) {
+        pool.Free(object);
+    }
+    EXPECT_EQ(1, pool.Slabs());
+}
+
+TEST(SmallTest, SizeClasses) {
+    for (size_t size : {1, 16, 17, 255, 256, 257, 320, 321, 1000, 4097, 8192, 8193, 100000}) {
+        char *p = static_cast<char *>(Small::Alloc(size));
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) % 16);
+        memset(p, 0x5a, size);
+        Small::Free(p, size);
+    }
+}
+
+TEST(SmallTest, CrossThreadFree) {
+    const size_t count = 10000;
+    vector<void *> objects(count);
+
+    thread producer([&objects]() {
+        for (size_t i = 0; i < objects.size(); i++) {
+            objects[i] = Small::Alloc(i % 500 + 1);
+            memset(objects[i], 1, i % 500 + 1);
+        }
+    });
+    producer.join();
+
+    // Producer is gone already, its cache is waiting for the next thread
+    for (size_t i = 0; i < objects.size(); i++) {
+        Small::Free(objects[i], i % 500 + 1);
+    }
+
+    thread next([&objects]() {
+        for (size_t i = 0; i < objects.size(); i++) {
+            objects[i] = Small::Alloc(64);
+        }
+        for (size_t i = 0; i < objects.size(); i++) {
+            Small::Free(objects[i], 64);
+        }
+    });
+    next.join();
+}
+
+TEST(SmallTest, StlAllocator) {
+    typedef basic_string<char, char_traits<char>, SmallAllocator<char>> small_string;
+
+    vector<small_string, SmallAllocator<small_string>> strings;
+    for (int i = 0; i < 1000; i++) {
+        strings.emplace_back(100 + i % 50, 'a' + i % 26);
+    }
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_EQ(small_string(100 + i % 50, 'a' + i % 26), strings[i]);
+    }
+}
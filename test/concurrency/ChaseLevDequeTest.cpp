@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "concurrency/ChaseLevDeque.h"
+
+using namespace Afina::Concurrency;
+
+TEST(ChaseLevDequeTest, OwnerIsLifoThiefIsFifo) {
+    ChaseLevDeque<int> deque(4);
+    std::vector<int> items = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    // Pushes above capacity grow the array
+    for (int &i : items) {
+        deque.Push(&i);
+    }
+    ASSERT_EQ(10, deque.Size());
+
+    ASSERT_EQ(&items[9], deque.Take());
+    ASSERT_EQ(&items[0], deque.Steal());
+    ASSERT_EQ(&items[8], deque.Take());
+    ASSERT_EQ(&items[1], deque.Steal());
+    ASSERT_EQ(6, deque.Size());
+
+    for (int i = 0; i < 6; i++) {
+        ASSERT_NE(nullptr, deque.Take());
+    }
+    ASSERT_EQ(nullptr, deque.Take());
+    ASSERT_EQ(nullptr, deque.Steal());
+    ASSERT_EQ(0, deque.Size());
+}
+
+TEST(ChaseLevDequeTest, EveryItemIsTakenOnce) {
+    const int count = 100000;
+    std::vector<int> items(count);
+    std::vector<std::atomic<int>> seen(count);
+    for (int i = 0; i < count; i++) {
+        items[i] = i;
+        seen[i] = 0;
+    }
+
+    ChaseLevDeque<int> deque(16);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < 3; i++) {
+        thieves.emplace_back([&]() {
+            while (!done || deque.Size() > 0) {
+                int *item = deque.Steal();
+                if (item != nullptr) {
+                    seen[*item]++;
+                }
+            }
+        });
+    }
+
+    // Owner pushes and takes concurrently with thieves, the last item is the most contended
+    for (int i = 0; i < count; i++) {
+        deque.Push(&items[i]);
+        if (i % 3 == 0) {
+            int *item = deque.Take();
+            if (item != nullptr) {
+                seen[*item]++;
+            }
+        }
+    }
+    while (int *item = deque.Take()) {
+        seen[*item]++;
+    }
+    done = true;
+
+    for (std::thread &t : thieves) {
+        t.join();
+    }
+    for (int i = 0; i < count; i++) {
+        ASSERT_EQ(1, seen[i]) << "item " << i;
+    }
+}
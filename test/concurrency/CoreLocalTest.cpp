@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/CoreLocal.h>
+#include <afina/concurrency/CoreRWLock.h>
+
+using namespace Afina::Concurrency;
+
+TEST(CoreLocalTest, SlotPerCpu) {
+    CoreLocal<long> values;
+    ASSERT_GE(values.Size(), 1);
+    ASSERT_LT(values.Index(), values.Size());
+
+    // Every slot starts on its own cache line
+    for (size_t i = 0; i < values.Size(); i++) {
+        ASSERT_EQ(0, reinterpret_cast<uintptr_t>(&values.At(i)) % 64);
+        ASSERT_EQ(0, values.At(i));
+    }
+
+    values.Get() = 5;
+    long sum = 0;
+    for (size_t i = 0; i < values.Size(); i++) {
+        sum += values.At(i);
+    }
+    ASSERT_EQ(5, sum);
+}
+
+TEST(CoreLocalTest, ConcurrentCounters) {
+    CoreLocal<std::atomic<long>> counters;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&counters]() {
+            for (int i = 0; i < 10000; i++) {
+                counters.Get().fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    long sum = 0;
+    for (size_t i = 0; i < counters.Size(); i++) {
+        sum += counters.At(i);
+    }
+    ASSERT_EQ(40000, sum);
+}
+
+TEST(CoreRWLockTest, WriterExcludesReaders) {
+    CoreRWLock lock;
+    long first = 0, second = 0;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&lock, &first, &second, t]() {
+            for (int i = 0; i < 10000; i++) {
+                if (t == 0) {
+                    lock.WriteLock();
+                    first++;
+                    second++;
+                    lock.WriteUnlock();
+                } else {
+                    size_t slot = lock.ReadLock();
+                    EXPECT_EQ(first, second);
+                    lock.ReadUnlock(slot);
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    ASSERT_EQ(10000, first);
+}
@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <afina/concurrency/Executor.h>
+
+using namespace Afina::Concurrency;
+
+namespace {
+
+// Spins until condition holds or a second passes
+template <typename P> bool WaitFor(P predicate) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > until) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void Hold(std::atomic<int> &running, std::atomic<bool> &release) {
+    running++;
+    while (!release) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    running--;
+}
+
+} // namespace
+
+TEST(ExecutorTest, RunsAllTasks) {
+    Executor executor("test", 2, 4, 100, std::chrono::milliseconds(100));
+
+    std::atomic<int> counter(0);
+    for (int i = 0; i < 50; i++) {
+        ASSERT_TRUE(executor.Execute([&counter]() { counter++; }));
+    }
+
+    // Queued tasks are completed before threads finish
+    executor.Stop(true);
+    ASSERT_EQ(50, counter);
+}
+
+TEST(ExecutorTest, RejectsWhenQueueIsFull) {
+    Executor executor("test", 1, 1, 2, std::chrono::milliseconds(100));
+
+    std::atomic<int> running(0);
+    std::atomic<bool> release(false);
+    ASSERT_TRUE(executor.Execute(Hold, std::ref(running), std::ref(release)));
+    ASSERT_TRUE(WaitFor([&running]() { return running == 1; }));
+
+    // The only thread is busy, two tasks fit into the queue
+    ASSERT_TRUE(executor.Execute(Hold, std::ref(running), std::ref(release)));
+    ASSERT_TRUE(executor.Execute(Hold, std::ref(running), std::ref(release)));
+    ASSERT_FALSE(executor.Execute(Hold, std::ref(running), std::ref(release)));
+
+    release = true;
+    executor.Stop(true);
+    ASSERT_EQ(0, running);
+}
+
+TEST(ExecutorTest, GrowsUpToHighWatermark) {
+    Executor executor("test", 1, 3, 10, std::chrono::milliseconds(20));
+
+    std::atomic<int> running(0);
+    std::atomic<bool> release(false);
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(executor.Execute(Hold, std::ref(running), std::ref(release)));
+    }
+    ASSERT_TRUE(WaitFor([&running]() { return running == 3; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(3, running);
+
+    // Extra threads finish after idle time and get started again once needed
+    release = true;
+    ASSERT_TRUE(WaitFor([&running]() { return running == 0; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    release = false;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(executor.Execute(Hold, std::ref(running), std::ref(release)));
+    }
+    ASSERT_TRUE(WaitFor([&running]() { return running == 3; }));
+
+    release = true;
+    executor.Stop(true);
+}
+
+TEST(ExecutorTest, RejectsAfterStop) {
+    Executor executor("test", 2, 2, 10, std::chrono::milliseconds(100));
+    executor.Stop();
+
+    std::atomic<int> counter(0);
+    ASSERT_FALSE(executor.Execute([&counter]() { counter++; }));
+    executor.Stop(true);
+    ASSERT_EQ(0, counter);
+}
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/FlatCombine.h>
+
+using namespace Afina::Concurrency;
+
+namespace {
+
+struct Add {
+    int delta;
+    long result;
+};
+
+} // namespace
+
+TEST(FlatCombineTest, SingleThread) {
+    long sum = 0;
+    FlatCombine<Add> combine([&sum](Add *const *ops, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            sum += ops[i]->delta;
+            ops[i]->result = sum;
+        }
+    });
+
+    Add op{5, 0};
+    combine.Execute(op);
+    ASSERT_EQ(5, op.result);
+
+    op.delta = 3;
+    combine.Execute(op);
+    ASSERT_EQ(8, op.result);
+}
+
+TEST(FlatCombineTest, OperationsAreNotLost) {
+    const int threads_count = 4;
+    const int ops_count = 20000;
+
+    // Plain variables, combiner is the only one touching them
+    long sum = 0;
+    size_t max_batch = 0;
+    FlatCombine<Add> combine(
+        [&sum, &max_batch](Add *const *ops, size_t count) {
+            max_batch = std::max(max_batch, count);
+            for (size_t i = 0; i < count; i++) {
+                sum += ops[i]->delta;
+                ops[i]->result = sum;
+            }
+        },
+        2);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; t++) {
+        threads.emplace_back([&combine, ops_count]() {
+            long last = 0;
+            for (int i = 0; i < ops_count; i++) {
+                Add op{1, 0};
+                combine.Execute(op);
+
+                // Sum only grows, so every thread sees its results in increasing order
+                EXPECT_GT(op.result, last);
+                last = op.result;
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(threads_count * ops_count, sum);
+    ASSERT_LE(max_batch, 2);
+}
+
+TEST(FlatCombineTest, SeveralInstances) {
+    long first = 0, second = 0;
+    FlatCombine<Add> a([&first](Add *const *ops, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            first += ops[i]->delta;
+        }
+    });
+    FlatCombine<Add> b([&second](Add *const *ops, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            second += ops[i]->delta;
+        }
+    });
+
+    // Thread has a separate slot in each of them
+    for (int i = 0; i < 10; i++) {
+        Add op{1, 0};
+        a.Execute(op);
+        b.Execute(op);
+        b.Execute(op);
+    }
+    ASSERT_EQ(10, first);
+    ASSERT_EQ(20, second);
+}
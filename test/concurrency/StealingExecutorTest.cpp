@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <afina/concurrency/StealingExecutor.h>
+
+using namespace Afina::Concurrency;
+
+TEST(StealingExecutorTest, RunsAllTasks) {
+    StealingExecutor executor("test", 4);
+
+    std::atomic<int> counter(0);
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(executor.Execute([&counter]() { counter++; }));
+    }
+
+    // Queued tasks are completed before threads finish
+    executor.Stop(true);
+    ASSERT_EQ(1000, counter);
+}
+
+void Spawn(StealingExecutor &executor, std::atomic<int> &counter, int depth) {
+    counter++;
+    if (depth > 0) {
+        executor.Execute(Spawn, std::ref(executor), std::ref(counter), depth - 1);
+        executor.Execute(Spawn, std::ref(executor), std::ref(counter), depth - 1);
+    }
+}
+
+TEST(StealingExecutorTest, TasksSpawnTasks) {
+    StealingExecutor executor("test", 4);
+
+    // Subtasks go to the deque of the thread spawned them and are stolen by the rest
+    std::atomic<int> counter(0);
+    ASSERT_TRUE(executor.Execute(Spawn, std::ref(executor), std::ref(counter), 14));
+
+    auto until = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (counter < (1 << 15) - 1 && std::chrono::steady_clock::now() < until) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    executor.Stop(true);
+    ASSERT_EQ((1 << 15) - 1, counter);
+}
+
+TEST(StealingExecutorTest, RejectsAfterStop) {
+    StealingExecutor executor("test", 2);
+    executor.Stop();
+
+    std::atomic<int> counter(0);
+    ASSERT_FALSE(executor.Execute([&counter]() { counter++; }));
+    executor.Stop(true);
+    ASSERT_EQ(0, counter);
+}
@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+using namespace Afina::Concurrency;
+
+TEST(ThreadLocalTest, ValuePerThread) {
+    ThreadLocal<long> values;
+    values.Get() = 1;
+    ASSERT_EQ(&values.Get(), &values.Get());
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(&values.Get()) % 64);
+
+    long *other = nullptr;
+    std::thread t([&values, &other]() {
+        ASSERT_EQ(0, values.Get());
+        values.Get() = 2;
+        other = &values.Get();
+    });
+    t.join();
+    ASSERT_NE(other, &values.Get());
+    ASSERT_EQ(1, values.Get());
+
+    // Value of the finished thread is still there
+    long sum = 0;
+    size_t count = 0;
+    values.ForEach([&sum, &count](const long &v) {
+        sum += v;
+        count++;
+    });
+    ASSERT_EQ(2, count);
+    ASSERT_EQ(3, sum);
+}
+
+TEST(ThreadLocalTest, Instances) {
+    // Thread caches the last instance used, switching between them must not mix values up
+    ThreadLocal<int> a, b;
+    for (int i = 0; i < 10; i++) {
+        a.Get()++;
+        b.Get() += 2;
+    }
+    ASSERT_EQ(10, a.Get());
+    ASSERT_EQ(20, b.Get());
+
+    // New instance is never confused with destroyed one, even at the same address
+    for (int i = 0; i < 10; i++) {
+        ThreadLocal<int> c;
+        ASSERT_EQ(0, c.Get());
+        c.Get() = 5;
+    }
+}
+
+TEST(ThreadLocalTest, ConcurrentCounters) {
+    ThreadLocal<std::atomic<long>> counters;
+    std::atomic<bool> done(false);
+
+    // Reader walks over the values while they are created and updated
+    std::thread reader([&counters, &done]() {
+        while (!done.load()) {
+            long sum = 0;
+            counters.ForEach([&sum](const std::atomic<long> &v) { sum += v.load(std::memory_order_relaxed); });
+            ASSERT_GE(sum, 0);
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&counters]() {
+            for (int i = 0; i < 10000; i++) {
+                std::atomic<long> &v = counters.Get();
+                v.store(v.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    done = true;
+    reader.join();
+
+    long sum = 0;
+    counters.ForEach([&sum](const std::atomic<long> &v) { sum += v.load(); });
+    ASSERT_EQ(40000, sum);
+}
+
+TEST(ThreadLocalTest, ReuseAfterThreadExit) {
+    ThreadLocal<long> values;
+
+    // Every next thread takes over value of the previous one instead of adding a new one
+    for (int i = 0; i < 10; i++) {
+        std::thread t([&values]() { values.Get()++; });
+        t.join();
+    }
+
+    long sum = 0;
+    size_t count = 0;
+    values.ForEach([&sum, &count](const long &v) {
+        sum += v;
+        count++;
+    });
+    ASSERT_EQ(1, count);
+    ASSERT_EQ(10, sum);
+
+    // Thread finishing after the instance is gone leaves it alone
+    std::thread t([]() {
+        ThreadLocal<long> local;
+        local.Get() = 1;
+    });
+    t.join();
+}
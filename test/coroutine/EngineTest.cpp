@@ -62,3 +62,94 @@ TEST(CoroutineTest, Printer) {
     engine.start(_printer, engine, result);
     ASSERT_STREQ("A1 B1 A2 B2 A3 B3 END", result.c_str());
 }
+
+void _blocked(Afina::Coroutine::Engine &pe, std::stringstream &out) {
+    out << "B1 ";
+    pe.block();
+
+    out << "B2 ";
+}
+
+void _waker(Afina::Coroutine::Engine &pe, std::stringstream &out, void *&other) {
+    out << "W1 ";
+    pe.yield();
+
+    out << "W2 ";
+    pe.unblock(other);
+    pe.yield();
+
+    out << "W3 ";
+}
+
+std::stringstream block_out;
+void *pblocked = nullptr;
+void _block_main(Afina::Coroutine::Engine &pe, void *&self, std::string &result) {
+    self = pe.current();
+    pblocked = pe.run(_blocked, pe, block_out);
+    pe.run(_waker, pe, block_out, pblocked);
+
+    // Others run until all of them are done or blocked, then unblocker wakes main up
+    pe.block();
+    result = block_out.str();
+}
+
+TEST(CoroutineTest, BlockUnblock) {
+    void *main = nullptr;
+    Afina::Coroutine::Engine engine([&main](Afina::Coroutine::Engine &pe) { pe.unblock(main); });
+
+    std::string result;
+    engine.start(_block_main, engine, main, result);
+    ASSERT_STREQ("W1 B1 W2 B2 W3 ", result.c_str());
+}
+
+void _noop_unblocker(Afina::Coroutine::Engine &) {}
+
+TEST(CoroutineTest, SeparateStackSimpleStart) {
+    Afina::Coroutine::Engine engine(_noop_unblocker, 64 * 1024);
+
+    int result;
+    engine.start(_calculator_add, result, 1, 2);
+
+    ASSERT_EQ(3, result);
+}
+
+TEST(CoroutineTest, SeparateStackPrinter) {
+    Afina::Coroutine::Engine engine(_noop_unblocker, 64 * 1024);
+    out.str("");
+
+    std::string result;
+    engine.start(_printer, engine, result);
+    ASSERT_STREQ("A1 B1 A2 B2 A3 B3 END", result.c_str());
+}
+
+TEST(CoroutineTest, SeparateStackBlockUnblock) {
+    void *main = nullptr;
+    Afina::Coroutine::Engine engine([&main](Afina::Coroutine::Engine &pe) { pe.unblock(main); }, 64 * 1024);
+    block_out.str("");
+
+    std::string result;
+    engine.start(_block_main, engine, main, result);
+    ASSERT_STREQ("W1 B1 W2 B2 W3 ", result.c_str());
+}
+
+void _counter(Afina::Coroutine::Engine &pe, int &counter) {
+    counter++;
+    pe.yield();
+    counter++;
+}
+
+void _spawner(Afina::Coroutine::Engine &pe, int &counter) {
+    // Stacks of finished routines are reused by the new ones
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_NE(nullptr, pe.run(_counter, pe, counter));
+        pe.yield();
+    }
+}
+
+TEST(CoroutineTest, SeparateStackMany) {
+    Afina::Coroutine::Engine engine(_noop_unblocker, 64 * 1024);
+
+    int counter = 0;
+    engine.start(_spawner, engine, counter);
+    ASSERT_EQ(2000, counter);
+}
@@ -0,0 +1,177 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <afina/coroutine/Scheduler.h>
+
+using namespace Afina::Coroutine;
+
+TEST(SchedulerTest, RunsEverything) {
+    Scheduler scheduler(nullptr);
+    std::atomic<int> counter(0);
+    for (int i = 0; i < 100; i++) {
+        scheduler.run([&scheduler, &counter]() {
+            for (int j = 0; j < 10; j++) {
+                counter++;
+                scheduler.yield();
+            }
+        });
+    }
+
+    scheduler.Start(4);
+    scheduler.Stop();
+    scheduler.Join();
+    ASSERT_EQ(1000, counter);
+}
+
+TEST(SchedulerTest, NestedRun) {
+    Scheduler scheduler(nullptr);
+    std::atomic<int> counter(0);
+    scheduler.run([&scheduler, &counter]() {
+        for (int i = 0; i < 50; i++) {
+            scheduler.run([&counter]() { counter++; });
+        }
+    });
+
+    // Stop waits for coroutines started by other coroutines as well
+    scheduler.Start(2);
+    scheduler.Stop();
+    scheduler.Join();
+    ASSERT_EQ(50, counter);
+}
+
+TEST(SchedulerTest, BlockUnblock) {
+    Scheduler scheduler(nullptr);
+    std::atomic<void *> sleeper(nullptr);
+    std::atomic<bool> woken(false);
+
+    scheduler.run([&scheduler, &sleeper, &woken]() {
+        sleeper = Scheduler::current();
+        scheduler.block();
+        woken = true;
+    });
+    scheduler.run([&scheduler, &sleeper, &woken]() {
+        while (sleeper == nullptr) {
+            scheduler.yield();
+        }
+        EXPECT_FALSE(woken);
+        scheduler.unblock(sleeper);
+    });
+
+    scheduler.Start(2);
+    scheduler.Stop();
+    scheduler.Join();
+    ASSERT_TRUE(woken);
+}
+
+TEST(SchedulerTest, UnblockBeforeBlock) {
+    Scheduler scheduler(nullptr);
+    std::atomic<bool> done(false);
+
+    scheduler.run([&scheduler, &done]() {
+        // Wakeup is remembered, so coroutine doesn't sleep forever
+        scheduler.unblock(Scheduler::current());
+        scheduler.block();
+        done = true;
+    });
+
+    scheduler.Start(1);
+    scheduler.Stop();
+    scheduler.Join();
+    ASSERT_TRUE(done);
+}
+
+TEST(SchedulerTest, PollerWakesUp) {
+    std::atomic<void *> sleeper(nullptr);
+    std::atomic<int> polls(0);
+    Scheduler scheduler([&sleeper, &polls](Scheduler &s, int timeout) {
+        polls++;
+        void *coro = sleeper.exchange(nullptr);
+        if (coro != nullptr) {
+            s.unblock(coro);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    std::atomic<int> wakeups(0);
+    scheduler.run([&scheduler, &sleeper, &wakeups]() {
+        for (int i = 0; i < 5; i++) {
+            sleeper = Scheduler::current();
+            scheduler.block();
+            wakeups++;
+        }
+    });
+
+    scheduler.Start(3);
+    scheduler.Stop();
+    scheduler.Join();
+    ASSERT_EQ(5, wakeups);
+    ASSERT_GE(polls, 5);
+}
+
+TEST(SchedulerTest, WorkIsStolen) {
+    Scheduler scheduler(nullptr);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+
+    // Everything is spawned into the queue of a single worker, the others have to steal
+    scheduler.run([&]() {
+        for (int i = 0; i < 200; i++) {
+            scheduler.run([&]() {
+                auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(200);
+                while (std::chrono::steady_clock::now() < until) {
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                threads.insert(std::this_thread::get_id());
+            });
+        }
+    });
+
+    scheduler.Start(4);
+    scheduler.Stop();
+    scheduler.Join();
+    ASSERT_GT(threads.size(), 1);
+}
+
+TEST(SchedulerTest, MigratesBetweenThreads) {
+    Scheduler scheduler(nullptr);
+    std::atomic<int> counter(0);
+
+    // Locals survive however many times coroutines move from one thread to another
+    for (int i = 0; i < 8; i++) {
+        scheduler.run([&scheduler, &counter, i]() {
+            int local = i;
+            for (int j = 0; j < 1000; j++) {
+                local += j;
+                scheduler.yield();
+            }
+            counter += local - i;
+        });
+    }
+
+    scheduler.Start(4);
+    scheduler.Stop();
+    scheduler.Join();
+    ASSERT_EQ(8 * (999 * 1000 / 2), counter);
+}
+
+TEST(SchedulerTest, NoMemoryForStack) {
+    // Nobody could map that much
+    Scheduler scheduler(nullptr, size_t(1) << 62);
+    std::atomic<int> started(0), failed(0);
+    for (int i = 0; i < 10; i++) {
+        scheduler.run([&started]() { started++; }, [&failed]() { failed++; });
+    }
+
+    scheduler.Start(2);
+    scheduler.Stop();
+    scheduler.Join();
+    ASSERT_EQ(0, started);
+    ASSERT_EQ(10, failed);
+}
@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+
+#include <ctime>
+#include <string>
+
+#include <afina/execute/Add.h>
+#include <afina/execute/Append.h>
+#include <afina/execute/Set.h>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina::Backend;
+using namespace Afina::Execute;
+using namespace std;
+
+TEST(InsertCommandTest, ExpireAt) {
+    time_t now = time(nullptr);
+
+    EXPECT_EQ(0, Set("KEY", 0, 0).ExpireAt());
+    EXPECT_LT(0, Set("KEY", 0, -1).ExpireAt());
+    EXPECT_GE(now, Set("KEY", 0, -1).ExpireAt());
+
+    // Up to 30 days exptime is relative, then it is unix time
+    EXPECT_LE(now + 3600, Set("KEY", 0, 3600).ExpireAt());
+    EXPECT_GE(time(nullptr) + 3600, Set("KEY", 0, 3600).ExpireAt());
+    EXPECT_EQ(60 * 60 * 24 * 30 + 1, Set("KEY", 0, 60 * 60 * 24 * 30 + 1).ExpireAt());
+}
+
+TEST(InsertCommandTest, ExpiredItemIsNotVisible) {
+    SimpleLRU storage;
+    std::string out, value;
+
+    Set("KEY1", 0, 3600).Execute(storage, "val1", out);
+    EXPECT_EQ("STORED", out);
+    EXPECT_TRUE(storage.Get("KEY1", value));
+
+    Set("KEY1", 0, -1).Execute(storage, "val2", out);
+    EXPECT_EQ("STORED", out);
+    EXPECT_FALSE(storage.Get("KEY1", value));
+
+    Add("KEY2", 0, -1).Execute(storage, "val2", out);
+    EXPECT_EQ("STORED", out);
+    EXPECT_FALSE(storage.Get("KEY2", value));
+}
+
+TEST(InsertCommandTest, AppendKeepsExpiration) {
+    SimpleLRU storage;
+    std::string out, value;
+    time_t expire_at;
+
+    Set("KEY1", 0, 3600).Execute(storage, "val1", out);
+    EXPECT_TRUE(storage.Get("KEY1", value, expire_at));
+    EXPECT_LT(0, expire_at);
+
+    // Expiration of the command is ignored, even if it is in the past
+    Append("KEY1", 0, -1).Execute(storage, "more", out);
+    EXPECT_EQ("STORED", out);
+    time_t appended_expire_at;
+    EXPECT_TRUE(storage.Get("KEY1", value, appended_expire_at));
+    EXPECT_EQ("val1more", value);
+    EXPECT_EQ(expire_at, appended_expire_at);
+
+    Set("KEY2", 0, 0).Execute(storage, "val2", out);
+    Append("KEY2", 0, 3600).Execute(storage, "more", out);
+    EXPECT_TRUE(storage.Get("KEY2", value, expire_at));
+    EXPECT_EQ(0, expire_at);
+}
@@ -0,0 +1,43 @@
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include <afina/execute/Get.h>
+#include <afina/execute/Keys.h>
+
+using namespace Afina;
+
+TEST(KeysTest, Views) {
+    Execute::Keys keys;
+    ASSERT_TRUE(keys.Empty());
+
+    keys.Add("foo");
+    keys.Add("", 0);
+    keys.Add("some_rather_long_key_name", 25);
+    ASSERT_EQ(3, keys.Size());
+    EXPECT_EQ("foo", keys[0].str());
+    EXPECT_EQ(0, keys[1].size);
+    EXPECT_EQ("some_rather_long_key_name", keys[2].str());
+
+    // Commands get their own copy
+    Execute::Get get(keys);
+    keys.Clear();
+    ASSERT_TRUE(keys.Empty());
+    EXPECT_EQ(std::vector<std::string>({"foo", "", "some_rather_long_key_name"}), get.keys());
+}
+
+TEST(KeysTest, Reuse) {
+    Execute::Keys keys;
+    for (int i = 0; i < 100; i++) {
+        keys.Add("key" + std::to_string(i));
+    }
+    const char *data = keys[0].data;
+
+    // Memory is kept for the next command
+    keys.Clear();
+    for (int i = 0; i < 100; i++) {
+        keys.Add("key" + std::to_string(i));
+    }
+    EXPECT_EQ(data, keys[0].data);
+    EXPECT_EQ("key99", keys[99].str());
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include <afina/execute/Get.h>
+#include <afina/execute/Response.h>
+
+#include "storage/SimpleLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+
+static std::string Collect(const Execute::Response &response) {
+    struct iovec iov[16];
+    size_t n = response.Fill(iov, 16);
+
+    std::string result;
+    for (size_t i = 0; i < n; i++) {
+        result.append(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+    }
+    return result;
+}
+
+TEST(ResponseTest, PartialConsume) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "bar");
+
+    Execute::Response response;
+    ValueView value;
+    ASSERT_TRUE(storage.Pin("foo", value));
+
+    response.Append("head ");
+    response.Append(std::move(value));
+    response.Append(" tail");
+    EXPECT_EQ("head bar tail", Collect(response));
+
+    response.Consume(3);
+    EXPECT_EQ("d bar tail", Collect(response));
+
+    response.Consume(4);
+    EXPECT_EQ("r tail", Collect(response));
+
+    response.Consume(6);
+    EXPECT_TRUE(response.Empty());
+}
+
+TEST(ResponseTest, GetPinsValues) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "bar");
+    storage.Put("baz", "qux");
+
+    Execute::Get get({"foo", "missing", "baz"});
+    Execute::Response response;
+    get.Execute(storage, "", response);
+
+    std::string copied;
+    get.Execute(storage, "", copied);
+
+    EXPECT_EQ("VALUE foo 0 3\r\nbar\r\nVALUE baz 0 3\r\nqux\r\nEND", Collect(response));
+    EXPECT_EQ(copied, Collect(response));
+}
+
+// Empty value must not stay pinned in the view reused for the next key, locking storages would
+// release it under their own lock otherwise
+TEST(ResponseTest, EmptyValue) {
+    Backend::ThreadSafeSimplLRU locked;
+    Backend::StripedLRU striped;
+    for (Storage *storage : {static_cast<Storage *>(&locked), static_cast<Storage *>(&striped)}) {
+        storage->Put("a", "");
+        storage->Put("b", "x");
+        storage->Put("c", "");
+
+        Execute::Get get({"a", "b", "c", "b"});
+        Execute::Response response;
+        get.Execute(*storage, "", response);
+        EXPECT_EQ("VALUE a 0 0\r\n\r\nVALUE b 0 1\r\nx\r\nVALUE c 0 0\r\n\r\nVALUE b 0 1\r\nx\r\nEND",
+                  Collect(response));
+    }
+}
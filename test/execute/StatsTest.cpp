@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <afina/Counters.h>
+#include <afina/execute/Get.h>
+#include <afina/execute/Set.h>
+#include <afina/execute/Stats.h>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+
+// Parses "STAT <name> <value>\r\n" lines, checks that output is terminated by END
+static std::unordered_map<std::string, uint64_t> Collect(Storage &storage) {
+    std::string out;
+    Execute::Stats().Execute(storage, "", out);
+
+    std::unordered_map<std::string, uint64_t> result;
+    std::stringstream in(out);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line == "END") {
+            EXPECT_TRUE(in.peek() == EOF);
+            return result;
+        }
+
+        EXPECT_EQ('\r', line.back());
+        std::stringstream fields(line);
+        std::string stat, name;
+        uint64_t value;
+        fields >> stat >> name >> value;
+        EXPECT_EQ("STAT", stat);
+        result[name] = value;
+    }
+
+    ADD_FAILURE() << "No END in stats output";
+    return result;
+}
+
+TEST(StatsTest, Commands) {
+    Backend::SimpleLRU storage;
+    auto before = Collect(storage);
+    ASSERT_EQ(1, before.count("cmd_get"));
+    ASSERT_EQ(1, before.count("curr_connections"));
+
+    std::string out;
+    Execute::Set set("foo", 0, 0);
+    set.Execute(storage, "bar", out);
+
+    Execute::Get get({"foo", "missing"});
+    get.Execute(storage, "", out);
+
+    auto after = Collect(storage);
+    EXPECT_EQ(1, after["cmd_set"] - before["cmd_set"]);
+    EXPECT_EQ(2, after["cmd_get"] - before["cmd_get"]);
+    EXPECT_EQ(1, after["get_hits"] - before["get_hits"]);
+    EXPECT_EQ(1, after["get_misses"] - before["get_misses"]);
+}
+
+TEST(StatsTest, Threads) {
+    Backend::SimpleLRU storage;
+    auto before = Collect(storage);
+
+    // Counters of finished threads are still summed up
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 1000; i++) {
+                LocalCounters().bytes_read.Add(2);
+            }
+            LocalCounters().total_connections.Add();
+            LocalCounters().closed_connections.Add();
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    auto after = Collect(storage);
+    EXPECT_EQ(8000, after["bytes_read"] - before["bytes_read"]);
+    EXPECT_EQ(4, after["total_connections"] - before["total_connections"]);
+    EXPECT_EQ(before["curr_connections"], after["curr_connections"]);
+}
+
+TEST(StatsTest, Evictions) {
+    Backend::SimpleLRU storage(16);
+    auto before = Collect(storage);
+
+    storage.Put("a", "0123456789");
+    storage.Put("b", "0123456789");
+    storage.Put("c", "0123456789");
+
+    auto after = Collect(storage);
+    EXPECT_EQ(2, after["evictions"] - before["evictions"]);
+}
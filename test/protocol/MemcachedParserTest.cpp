@@ -2,9 +2,12 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <afina/execute/Add.h>
+#include <afina/execute/FlushAll.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/InsertCommand.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
 
@@ -27,11 +30,11 @@ TEST(MemcachedParserTest, SimpleSet) {
     ASSERT_EQ("set", parser.Name());
 
     size_t value_size;
-    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    Execute::Command *cmd = parser.Build(value_size);
     ASSERT_FALSE(cmd == nullptr);
     ASSERT_EQ(6, value_size);
 
-    Execute::Set *tmp = reinterpret_cast<Execute::Set *>(cmd.get());
+    Execute::Set *tmp = reinterpret_cast<Execute::Set *>(cmd);
     ASSERT_EQ("foo", tmp->key());
     ASSERT_EQ(0, tmp->flags());
     ASSERT_EQ(0, tmp->expire());
@@ -48,16 +51,35 @@ TEST(MemcachedParserTest, SimpleAdd) {
     ASSERT_EQ("add", parser.Name());
 
     size_t value_size;
-    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    Execute::Command *cmd = parser.Build(value_size);
     ASSERT_FALSE(cmd == nullptr);
     ASSERT_EQ(60, value_size);
 
-    Execute::Add *tmp = reinterpret_cast<Execute::Add *>(cmd.get());
+    Execute::Add *tmp = reinterpret_cast<Execute::Add *>(cmd);
     ASSERT_EQ("bar", tmp->key());
     ASSERT_EQ(10, tmp->flags());
     ASSERT_EQ(-1, tmp->expire());
 }
 
+// Verify multi digit expiration time of both signs
+TEST(MemcachedParserTest, ExpireTime) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("set foo 0 3600 6\r\n", consumed));
+    size_t value_size;
+    Execute::Command *cmd = parser.Build(value_size);
+    ASSERT_EQ(3600, reinterpret_cast<Execute::Set *>(cmd)->expire());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("set foo 0 -120 6\r\n", consumed));
+    cmd = parser.Build(value_size);
+    ASSERT_EQ(-120, reinterpret_cast<Execute::Set *>(cmd)->expire());
+
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("set foo 0 99999999999 6\r\n", consumed), std::runtime_error);
+}
+
 // Verify simple get command passed in a single string
 TEST(MemcachedParserTest, SimpleGet) {
     Protocol::Parser parser;
@@ -69,11 +91,11 @@ TEST(MemcachedParserTest, SimpleGet) {
     ASSERT_EQ("get", parser.Name());
 
     size_t value_size;
-    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    Execute::Command *cmd = parser.Build(value_size);
     ASSERT_FALSE(cmd == nullptr);
     ASSERT_EQ(0, value_size);
 
-    Execute::Get *tmp = reinterpret_cast<Execute::Get *>(cmd.get());
+    Execute::Get *tmp = reinterpret_cast<Execute::Get *>(cmd);
     std::vector<std::string> keys = tmp->keys();
     ASSERT_EQ(3, keys.size());
     ASSERT_EQ("ke", keys[0]);
@@ -91,10 +113,146 @@ TEST(MemcachedParserTest, Stats) {
     ASSERT_EQ("stats", parser.Name());
 
     size_t value_size;
-    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    Execute::Command *cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(0, value_size);
+
+    Execute::Stats *tmp = reinterpret_cast<Execute::Stats *>(cmd);
+    ASSERT_FALSE(tmp == nullptr);
+}
+
+TEST(MemcachedParserTest, FlushAll) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    bool cmd_avail = parser.Parse("flush_all\r\n", consumed);
+    ASSERT_TRUE(cmd_avail);
+    ASSERT_EQ(11, consumed);
+    ASSERT_EQ("flush_all", parser.Name());
+
+    size_t value_size;
+    Execute::Command *cmd = parser.Build(value_size);
     ASSERT_FALSE(cmd == nullptr);
     ASSERT_EQ(0, value_size);
+    ASSERT_FALSE(dynamic_cast<Execute::FlushAll *>(cmd) == nullptr);
+}
+
+// Feeds input byte by byte, so that it never has the whole line and goes through the state machine
+static bool ParseByByte(Protocol::Parser &parser, const std::string &input, size_t &consumed) {
+    consumed = 0;
+    for (size_t i = 0; i < input.size(); i++) {
+        size_t parsed = 0;
+        bool done = parser.Parse(&input[i], 1, parsed);
+        consumed += parsed;
+        if (done) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Verify that the whole line gives the same result as byte by byte input
+TEST(MemcachedParserTest, FastPathMatchesStateMachine) {
+    std::vector<std::string> lines = {"set foo 12 -30 6\r\n", "add bar 0 100 0\r\n", "append baz 1 2 3\r\n",
+                                      "get a\r\n", "stats\r\n", "flush_all\r\n"};
+
+    // Keys around the chunk boundaries
+    for (size_t length : {14, 15, 16, 17, 30, 31, 32, 33, 64, 100}) {
+        lines.push_back("get " + std::string(length, 'k') + " x " + std::string(length + 1, 'y') + "\r\n");
+        lines.push_back("set " + std::string(length, 'k') + " 1 2 3\r\n");
+    }
+
+    for (auto &line : lines) {
+        Protocol::Parser fast, slow;
+        size_t fast_consumed = 0, slow_consumed = 0;
+        ASSERT_TRUE(fast.Parse(line + "tail", fast_consumed)) << line;
+        ASSERT_TRUE(ParseByByte(slow, line, slow_consumed)) << line;
+        ASSERT_EQ(line.size(), fast_consumed) << line;
+        ASSERT_EQ(slow_consumed, fast_consumed) << line;
+        ASSERT_EQ(slow.Name(), fast.Name()) << line;
+
+        size_t fast_size = 0, slow_size = 0;
+        Execute::Command *fast_cmd = fast.Build(fast_size);
+        Execute::Command *slow_cmd = slow.Build(slow_size);
+        ASSERT_EQ(slow_size, fast_size) << line;
+
+        if (fast.Name() == "get") {
+            auto *fast_get = dynamic_cast<Execute::Get *>(fast_cmd);
+            auto *slow_get = dynamic_cast<Execute::Get *>(slow_cmd);
+            ASSERT_TRUE(fast_get != nullptr && slow_get != nullptr);
+            ASSERT_EQ(slow_get->keys(), fast_get->keys()) << line;
+        } else if (fast.Name() != "stats" && fast.Name() != "flush_all") {
+            auto *fast_insert = dynamic_cast<Execute::InsertCommand *>(fast_cmd);
+            auto *slow_insert = dynamic_cast<Execute::InsertCommand *>(slow_cmd);
+            ASSERT_TRUE(fast_insert != nullptr && slow_insert != nullptr);
+            ASSERT_EQ(slow_insert->key(), fast_insert->key()) << line;
+            ASSERT_EQ(slow_insert->flags(), fast_insert->flags()) << line;
+            ASSERT_EQ(slow_insert->expire(), fast_insert->expire()) << line;
+        }
+    }
+}
+
+// Verify lines the fast path leaves to the state machine
+TEST(MemcachedParserTest, Fallback) {
+    Protocol::Parser parser;
+    size_t consumed = 0, value_size = 0;
+
+    // Line isn't complete yet
+    ASSERT_FALSE(parser.Parse("get foo", consumed));
+    ASSERT_EQ(7, consumed);
+    ASSERT_TRUE(parser.Parse(" bar\r\n", consumed));
+    Execute::Command *cmd = parser.Build(value_size);
+    ASSERT_EQ(std::vector<std::string>({"foo", "bar"}), dynamic_cast<Execute::Get *>(cmd)->keys());
 
-    Execute::Stats *tmp = reinterpret_cast<Execute::Stats *>(cmd.get());
+    // More keys than the fast path takes
+    std::string line = "get";
+    for (int i = 0; i < 100; i++) {
+        line += " key" + std::to_string(i);
+    }
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse(line + "\r\n", consumed));
+    ASSERT_EQ(line.size() + 2, consumed);
+    cmd = parser.Build(value_size);
+    ASSERT_EQ(100, dynamic_cast<Execute::Get *>(cmd)->keys().size());
+
+    // Extra token
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("set foo 0 0 6 noreply\r\n", consumed));
+    parser.Build(value_size);
+    ASSERT_EQ(6, value_size);
+
+    // Errors are reported by the state machine
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("gut foo\r\n", consumed), std::runtime_error);
+    parser.Reset();
+    EXPECT_THROW(parser.Parse("set foo 0 0 99999999999\r\n", consumed), std::runtime_error);
+}
+
+// Verify that command objects are reused and carry arguments of the last command only
+TEST(MemcachedParserTest, CommandReuse) {
+    Protocol::Parser parser;
+    size_t consumed = 0, value_size = 0;
+
+    ASSERT_TRUE(parser.Parse("get a bb ccc\r\n", consumed));
+    Execute::Command *first = parser.Build(value_size);
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("get dddd\r\n", consumed));
+    Execute::Command *second = parser.Build(value_size);
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(std::vector<std::string>({"dddd"}), dynamic_cast<Execute::Get *>(second)->keys());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("set foo 1 2 3\r\n", consumed));
+    Execute::Command *set = parser.Build(value_size);
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("set longer_key 4 -5 6\r\n", consumed));
+    ASSERT_EQ(set, parser.Build(value_size));
+
+    auto *tmp = dynamic_cast<Execute::Set *>(set);
     ASSERT_FALSE(tmp == nullptr);
+    ASSERT_EQ("longer_key", tmp->key());
+    ASSERT_EQ(4, tmp->flags());
+    ASSERT_EQ(-5, tmp->expire());
+    ASSERT_EQ(6, value_size);
 }
@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+#include <ctime>
+#include <string>
+
+#include "storage/AllocLRU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+TEST(AllocLRUTest, PutGetDelete) {
+    AllocLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "val4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val4"));
+
+    // Too big item doesn't evict anything
+    std::string value;
+    EXPECT_FALSE(storage.Put("KEY3", std::string(1024, 'x')));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val4", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+
+    EXPECT_TRUE(storage.Put("KEY2", "new2", time(nullptr) - 1));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+
+    EXPECT_TRUE(storage.Put("KEY5", "val5"));
+    storage.FlushAll();
+    EXPECT_FALSE(storage.Get("KEY5", value));
+}
+
+TEST(AllocLRUTest, EvictLeastRecentlyUsed) {
+    AllocLRU storage(4096);
+
+    // Each item takes about 136 bytes with allocator headers, so area is almost full
+    const std::string val(100, 'x');
+    const size_t count = 29;
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), val));
+    }
+
+    for (size_t i = 1; i < count; i += 2) {
+        EXPECT_TRUE(storage.Delete("Key " + std::to_string(i)));
+    }
+
+    // Holes are too small, but area gets compacted instead of evicting anything
+    const std::string big(250, 'y');
+    EXPECT_TRUE(storage.Put("Big", big));
+
+    std::string value;
+    for (size_t i = 0; i < count; i += 2) {
+        EXPECT_TRUE(storage.Get("Key " + std::to_string(i), value));
+        EXPECT_EQ(val, value);
+    }
+    EXPECT_TRUE(storage.Get("Big", value));
+    EXPECT_EQ(big, value);
+
+    // Once area is full least recently used items go away
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_TRUE(storage.Put("New " + std::to_string(i), val));
+    }
+    EXPECT_FALSE(storage.Get("Big", value));
+    EXPECT_TRUE(storage.Get("New " + std::to_string(count - 1), value));
+}
+
+TEST(AllocLRUTest, TooBigWithHeaders) {
+    AllocLRU storage(1024);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+
+    // Item itself fits the area, but not along with allocator header and descriptor
+    std::string value;
+    EXPECT_FALSE(storage.Put("KEY2", std::string(1016, 'x')));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+}
+
+TEST(AllocLRUTest, TooBigAfterDescriptorsGrow) {
+    AllocLRU storage(1024);
+
+    // Every item takes a descriptor, the table stays even when items are gone
+    const size_t count = 20;
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), ""));
+    }
+    storage.FlushAll();
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+
+    // Item fits the empty area, but not along with the descriptors table
+    std::string value;
+    EXPECT_FALSE(storage.Put("KEY2", std::string(900, 'x')));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+}
+
+TEST(AllocLRUTest, EvictOnlyWhatIsNeeded) {
+    AllocLRU storage(4096);
+
+    const std::string val(100, 'x');
+    const size_t count = 29;
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), val));
+    }
+
+    // Hole left by the oldest item is too small, but along with the unused space it's enough
+    const std::string bigger(200, 'y');
+    EXPECT_TRUE(storage.Put("Big", bigger));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("Key 0", value));
+    for (size_t i = 1; i < count; i++) {
+        EXPECT_TRUE(storage.Get("Key " + std::to_string(i), value));
+    }
+    EXPECT_TRUE(storage.Get("Big", value));
+    EXPECT_EQ(bigger, value);
+}
+
+TEST(AllocLRUTest, GrowValue) {
+    AllocLRU storage(1024);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Set("KEY1", std::string(500, 'x')));
+    EXPECT_TRUE(storage.Put("KEY2", std::string(400, 'y')));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(std::string(500, 'x'), value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ(std::string(400, 'y'), value);
+
+    // Doesn't fit along with the other one
+    EXPECT_TRUE(storage.Put("KEY1", std::string(800, 'z')));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(std::string(800, 'z'), value);
+}
@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/ClockLRU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+TEST(ClockLRUTest, PutGetDelete) {
+    ClockLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "val4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val4"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val4", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+}
+
+TEST(ClockLRUTest, SecondChance) {
+    // Room for 4 entries exactly
+    ClockLRU storage(4 * 8);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+    EXPECT_TRUE(storage.Put("KEY4", "val4"));
+
+    // Recently read entries survive, first unreferenced one is evicted
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_TRUE(storage.Put("KEY5", "val5"));
+
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_TRUE(storage.Get("KEY4", value));
+    EXPECT_TRUE(storage.Get("KEY5", value));
+}
+
+TEST(ClockLRUTest, PinnedValueOutlivesUpdate) {
+    ClockLRU storage;
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+
+    Afina::ValueView pinned;
+    EXPECT_TRUE(storage.Pin("KEY1", pinned));
+    EXPECT_TRUE(storage.Put("KEY1", "new1"));
+    EXPECT_TRUE(storage.Delete("KEY1"));
+
+    EXPECT_EQ("val1", std::string(pinned.data(), pinned.size()));
+}
+
+TEST(ClockLRUTest, ConcurrentReaders) {
+    const size_t keys_count = 1000;
+    ClockLRU storage(keys_count * 32);
+    for (size_t i = 0; i < keys_count; i++) {
+        storage.Put("Key " + std::to_string(i), std::to_string(i));
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; t++) {
+        threads.emplace_back([&storage, t, keys_count]() {
+            std::string value;
+            for (size_t i = 0; i < keys_count; i++) {
+                if (t == 0) {
+                    storage.Put("Key " + std::to_string(i), std::to_string(i));
+                } else {
+                    EXPECT_TRUE(storage.Get("Key " + std::to_string(i), value));
+                    EXPECT_EQ(std::to_string(i), value);
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+}
+
+TEST(ClockLRUTest, CoreLocalReaders) {
+    const size_t keys_count = 1000;
+    ClockLRU storage(keys_count * 32, true);
+    for (size_t i = 0; i < keys_count; i++) {
+        storage.Put("Key " + std::to_string(i), std::to_string(i));
+    }
+
+    // Writer excludes readers on every CPU
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; t++) {
+        threads.emplace_back([&storage, t, keys_count]() {
+            std::string value;
+            for (size_t i = 0; i < keys_count; i++) {
+                std::string key = "Key " + std::to_string(i);
+                if (t == 0) {
+                    storage.Put(key, std::to_string(i + 1));
+                    storage.Put(key, std::to_string(i));
+                } else {
+                    EXPECT_TRUE(storage.Get(key, value));
+                    EXPECT_TRUE(value == std::to_string(i) || value == std::to_string(i + 1));
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    std::string value;
+    EXPECT_TRUE(storage.Delete("Key 1"));
+    EXPECT_FALSE(storage.Get("Key 1", value));
+}
+
+TEST(ClockLRUTest, Expiration) {
+    ClockLRU storage;
+    time_t now = time(nullptr);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1", now + 3600));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Set("KEY2", "new2", now - 1));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY3", "val3", now - 1));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_FALSE(storage.Get("KEY3", value));
+
+    // Slot of expired entry is reused
+    EXPECT_TRUE(storage.Put("KEY1", "val1", now - 1));
+    EXPECT_TRUE(storage.Put("KEY4", "val4", now + 3600));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY4", value));
+}
+
+TEST(ClockLRUTest, FlushAll) {
+    ClockLRU storage(4 * 8);
+    EXPECT_TRUE(storage.Put("KEY1", "val1", time(nullptr) + 3600));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+
+    Afina::ValueView pinned;
+    EXPECT_TRUE(storage.Pin("KEY1", pinned));
+    storage.FlushAll();
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_EQ("val1", std::string(pinned.data(), pinned.size()));
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(storage.Put("KEY" + std::to_string(i), "val" + std::to_string(i)));
+    }
+    EXPECT_TRUE(storage.Get("KEY0", value));
+}
@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/FlatCombineLRU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+TEST(FlatCombineLRUTest, PutGetDelete) {
+    FlatCombineLRU storage(1024);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "val4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val4", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+
+    storage.FlushAll();
+    EXPECT_FALSE(storage.Get("KEY2", value));
+}
+
+TEST(FlatCombineLRUTest, PinnedValue) {
+    FlatCombineLRU storage(1024);
+    EXPECT_TRUE(storage.Put("KEY", "val1"));
+
+    Afina::ValueView view;
+    EXPECT_TRUE(storage.Pin("KEY", view));
+    EXPECT_TRUE(storage.Put("KEY", "val2"));
+    EXPECT_EQ("val1", std::string(view.data(), view.size()));
+
+    // Previous pin is released before the new one is taken
+    EXPECT_TRUE(storage.Pin("KEY", view));
+    EXPECT_EQ("val2", std::string(view.data(), view.size()));
+    view.Reset();
+}
+
+TEST(FlatCombineLRUTest, ConcurrentAccess) {
+    const size_t threads_count = 4;
+    const size_t keys_count = 1000;
+    FlatCombineLRU storage(threads_count * keys_count * 32);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threads_count; t++) {
+        threads.emplace_back([&storage, t, keys_count]() {
+            for (size_t i = 0; i < keys_count; i++) {
+                std::string key = "Key " + std::to_string(t) + " " + std::to_string(i);
+                storage.Put(key, std::to_string(i));
+
+                std::string value;
+                EXPECT_TRUE(storage.Get(key, value));
+                EXPECT_EQ(std::to_string(i), value);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (size_t t = 0; t < threads_count; t++) {
+        for (size_t i = 0; i < keys_count; i++) {
+            std::string value;
+            std::string key = "Key " + std::to_string(t) + " " + std::to_string(i);
+            EXPECT_TRUE(storage.Get(key, value));
+            EXPECT_EQ(std::to_string(i), value);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/HashIndex.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+struct test_node {
+    std::string key;
+};
+
+struct test_key {
+    const std::string &operator()(const test_node &node) const { return node.key; }
+};
+
+using test_index = HashIndex<test_node, test_key>;
+
+TEST(HashIndexTest, InsertFindErase) {
+    test_index index;
+    test_node a{"a"}, b{"b"}, a2{"a"};
+
+    EXPECT_TRUE(index.Insert(&a));
+    EXPECT_TRUE(index.Insert(&b));
+    EXPECT_FALSE(index.Insert(&a2));
+    EXPECT_EQ(2, index.Size());
+
+    EXPECT_EQ(&a, index.Find("a"));
+    EXPECT_EQ(&b, index.Find("b"));
+    EXPECT_EQ(nullptr, index.Find("c"));
+
+    EXPECT_TRUE(index.Replace(&a2));
+    EXPECT_EQ(&a2, index.Find("a"));
+
+    EXPECT_EQ(&a2, index.Erase("a"));
+    EXPECT_EQ(nullptr, index.Erase("a"));
+    EXPECT_EQ(nullptr, index.Find("a"));
+    EXPECT_EQ(&b, index.Find("b"));
+    EXPECT_EQ(1, index.Size());
+}
+
+TEST(HashIndexTest, GrowAndShrink) {
+    const size_t count = 100000;
+    test_index index;
+
+    std::vector<std::unique_ptr<test_node>> nodes;
+    for (size_t i = 0; i < count; i++) {
+        nodes.emplace_back(new test_node{"Key " + std::to_string(i)});
+        ASSERT_TRUE(index.Insert(nodes.back().get()));
+    }
+
+    // Erase every other key, the rest must stay reachable after backward shifts
+    for (size_t i = 0; i < count; i += 2) {
+        ASSERT_EQ(nodes[i].get(), index.Erase(nodes[i]->key));
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        test_node *expected = (i % 2 == 0) ? nullptr : nodes[i].get();
+        ASSERT_EQ(expected, index.Find(nodes[i]->key));
+    }
+    EXPECT_EQ(count / 2, index.Size());
+
+    index.Clear();
+    EXPECT_EQ(0, index.Size());
+    EXPECT_EQ(nullptr, index.Find(nodes[1]->key));
+}
@@ -1,7 +1,10 @@
 #include "gtest/gtest.h"
+#include <chrono>
+#include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <set>
+#include <thread>
 #include <vector>
 
 #include <afina/execute/Add.h>
@@ -10,7 +13,13 @@
 #include <afina/execute/Get.h>
 #include <afina/execute/Set.h>
 
+#include "storage/AllocLRU.h"
+#include "storage/ClockLRU.h"
+#include "storage/FlatCombineLRU.h"
 #include "storage/SimpleLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/ThreadSafeTinyLFU.h"
 
 using namespace Afina::Backend;
 using namespace Afina::Execute;
@@ -195,3 +204,177 @@ TEST(StorageTest, MaxTest) {
         EXPECT_FALSE(storage.Get(key, res));
     }
 }
+
+TEST(StorageTest, GrowAndShrinkValue) {
+    SimpleLRU storage;
+
+    std::string big(700, 'x');
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+
+    // Value moves into a chunk of another size class
+    EXPECT_TRUE(storage.Set("KEY1", big));
+    EXPECT_TRUE(storage.Put("KEY2", big));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(value == big);
+
+    EXPECT_TRUE(storage.Put("KEY2", "short"));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(value == "short");
+}
+
+TEST(StorageTest, DeleteReleaseSpace) {
+    const size_t length = 20;
+    SimpleLRU storage(2 * 10 * length);
+
+    for (long i = 0; i < 10; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, val));
+    }
+
+    EXPECT_TRUE(storage.Delete(pad_space("Key 0", length)));
+    EXPECT_TRUE(storage.Put(pad_space("Key 10", length), pad_space("Val 10", length)));
+
+    // Nothing was evicted since deleted key released its space
+    std::string res;
+    for (long i = 1; i <= 10; ++i) {
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+    }
+}
+
+TEST(StorageTest, PinSurvivesUpdates) {
+    SimpleLRU storage(64);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+
+    Afina::ValueView pinned1, pinned2;
+    EXPECT_TRUE(storage.Pin("KEY1", pinned1));
+    EXPECT_TRUE(storage.Pin("KEY2", pinned2));
+
+    // Overwrite, delete and evict pinned values, views must still see old data
+    EXPECT_TRUE(storage.Put("KEY1", "new1"));
+    EXPECT_TRUE(storage.Delete("KEY2"));
+    EXPECT_TRUE(storage.Put("KEY3", std::string(56, 'x')));
+
+    EXPECT_EQ("val1", std::string(pinned1.data(), pinned1.size()));
+    EXPECT_EQ("val2", std::string(pinned2.data(), pinned2.size()));
+
+    pinned1.Reset();
+    pinned2.Reset();
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+}
+
+TEST(StorageTest, PinMissReleasesView) {
+    SimpleLRU simple;
+    ThreadSafeSimplLRU locked;
+    StripedLRU striped;
+    FlatCombineLRU combined;
+    ClockLRU clock;
+    AllocLRU alloc;
+    ThreadSafeTinyLFU tinylfu;
+    for (Afina::Storage *storage : std::vector<Afina::Storage *>{&simple, &locked, &striped, &combined, &clock, &alloc,
+                                                                 &tinylfu}) {
+        EXPECT_TRUE(storage->Put("KEY1", "val1"));
+
+        Afina::ValueView view;
+        EXPECT_TRUE(storage->Pin("KEY1", view));
+        EXPECT_FALSE(storage->Pin("KEY2", view));
+        EXPECT_EQ(nullptr, view.data());
+        EXPECT_EQ(0, view.size());
+    }
+}
+
+TEST(StorageTest, ExpiredOnArrival) {
+    SimpleLRU storage;
+    time_t past = time(nullptr) - 1;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+
+    // Stale value replaces existing one, but is never visible itself
+    EXPECT_TRUE(storage.Put("KEY1", "new1", past));
+    EXPECT_TRUE(storage.Set("KEY2", "new2", past));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY3", "val3", past));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_FALSE(storage.Get("KEY3", value));
+}
+
+TEST(StorageTest, ExpiredReleaseSpace) {
+    SimpleLRU storage(16);
+    time_t expire_at = time(nullptr) + 1;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2", expire_at));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    while (time(nullptr) < expire_at) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    // Expired item is reclaimed first, so least recently used one is not evicted
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+}
+
+TEST(StorageTest, FlushAll) {
+    const size_t length = 20;
+    SimpleLRU storage(2 * 100 * length);
+
+    for (int round = 0; round < 2; round++) {
+        for (long i = 0; i < 100; ++i) {
+            auto key = pad_space("Key " + std::to_string(i), length);
+            auto val = pad_space("Val " + std::to_string(i), length);
+            EXPECT_TRUE(storage.Put(key, val, i % 2 == 0 ? 0 : time(nullptr) + 3600));
+        }
+
+        storage.FlushAll();
+        std::string res;
+        for (long i = 0; i < 100; ++i) {
+            EXPECT_FALSE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+        }
+    }
+
+    // Whole budget is available again
+    for (long i = 0; i < 100; ++i) {
+        EXPECT_TRUE(storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val", length)));
+    }
+    std::string res;
+    EXPECT_TRUE(storage.Get(pad_space("Key 0", length), res));
+}
+
+TEST(StorageTest, FlushAllPinned) {
+    SimpleLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+
+    Afina::ValueView pinned;
+    EXPECT_TRUE(storage.Pin("KEY1", pinned));
+    storage.FlushAll();
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_EQ("val1", std::string(pinned.data(), pinned.size()));
+
+    // Once view is gone storage could drop memory in bulk again
+    pinned.Reset();
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+    storage.FlushAll();
+    EXPECT_FALSE(storage.Get("KEY3", value));
+}
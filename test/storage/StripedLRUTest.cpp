@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/StripedLRU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+TEST(StripedLRUTest, PutGetDelete) {
+    StripedLRU storage(1024, 4);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "val4"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val4", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+}
+
+TEST(StripedLRUTest, StripeBudget) {
+    // Each of 4 stripes could hold up to 10 bytes only
+    StripedLRU storage(40, 4);
+
+    EXPECT_TRUE(storage.Put("key", "1234567"));
+    EXPECT_FALSE(storage.Put("key", "12345678"));
+}
+
+TEST(StripedLRUTest, InvalidConfig) {
+    EXPECT_THROW(StripedLRU(1024, 0), std::invalid_argument);
+    EXPECT_THROW(StripedLRU(3, 4), std::invalid_argument);
+}
+
+TEST(StripedLRUTest, ConcurrentAccess) {
+    const size_t threads_count = 4;
+    const size_t keys_count = 1000;
+    StripedLRU storage(threads_count * keys_count * 32, 8);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threads_count; t++) {
+        threads.emplace_back([&storage, t, keys_count]() {
+            for (size_t i = 0; i < keys_count; i++) {
+                std::string key = "Key " + std::to_string(t) + " " + std::to_string(i);
+                storage.Put(key, std::to_string(i));
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (size_t t = 0; t < threads_count; t++) {
+        for (size_t i = 0; i < keys_count; i++) {
+            std::string value;
+            std::string key = "Key " + std::to_string(t) + " " + std::to_string(i);
+            EXPECT_TRUE(storage.Get(key, value));
+            EXPECT_EQ(std::to_string(i), value);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+#include <set>
+#include <vector>
+
+#include "storage/TimerWheel.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+namespace {
+
+TimerWheel::Entry MakeEntry(time_t expire_at) {
+    TimerWheel::Entry entry;
+    entry.expire_at = expire_at;
+    return entry;
+}
+
+} // namespace
+
+TEST(TimerWheelTest, FiresOnTime) {
+    const time_t start = 1000000;
+    TimerWheel wheel(start);
+
+    // Spread over all levels of the wheel, including far future that gets parked
+    std::vector<time_t> delays = {1, 2, 63, 64, 65, 100, 4095, 4096, 5000, 300000, 20000000, 2000000000};
+    std::vector<TimerWheel::Entry> entries;
+    for (auto delay : delays) {
+        entries.push_back(MakeEntry(start + delay));
+    }
+    for (auto &entry : entries) {
+        wheel.Schedule(entry);
+    }
+    EXPECT_EQ(delays.size(), wheel.Size());
+
+    size_t fired = 0;
+    for (auto delay : delays) {
+        if (delay > 300000) {
+            break;
+        }
+
+        // Nothing fires earlier than it should
+        wheel.Advance(start + delay - 1, [](TimerWheel::Entry *) { FAIL(); });
+        wheel.Advance(start + delay, [&](TimerWheel::Entry *entry) {
+            EXPECT_EQ(start + delay, entry->expire_at);
+            fired++;
+        });
+        EXPECT_EQ(delays.size() - fired, wheel.Size());
+    }
+    EXPECT_EQ(10, fired);
+
+    // Far timers are still there
+    wheel.Advance(start + 20000000 - 1, [](TimerWheel::Entry *) { FAIL(); });
+    wheel.Advance(start + 20000000, [&](TimerWheel::Entry *entry) { fired++; });
+    EXPECT_EQ(11, fired);
+    EXPECT_EQ(1, wheel.Size());
+}
+
+TEST(TimerWheelTest, CancelAndExpired) {
+    const time_t start = 5000;
+    TimerWheel wheel(start);
+
+    TimerWheel::Entry late = MakeEntry(start + 200);
+    TimerWheel::Entry canceled = MakeEntry(start + 10);
+    TimerWheel::Entry expired = MakeEntry(start - 10);
+    wheel.Schedule(late);
+    wheel.Schedule(canceled);
+    wheel.Schedule(expired);
+
+    // Cancel is safe after timer has been cascaded and for the entry not in the wheel
+    wheel.Advance(start + 100, [&](TimerWheel::Entry *entry) { EXPECT_EQ(&expired, entry); wheel.Cancel(canceled); });
+    wheel.Cancel(canceled);
+    wheel.Cancel(late);
+    EXPECT_EQ(0, wheel.Size());
+
+    wheel.Advance(start + 1000, [](TimerWheel::Entry *) { FAIL(); });
+}
+
+TEST(TimerWheelTest, LongJump) {
+    const time_t start = 100;
+    TimerWheel wheel(start);
+
+    std::vector<TimerWheel::Entry> entries;
+    for (time_t i = 1; i <= 10000; i += 7) {
+        entries.push_back(MakeEntry(start + i));
+    }
+    for (auto &entry : entries) {
+        wheel.Schedule(entry);
+    }
+
+    std::set<TimerWheel::Entry *> fired;
+    wheel.Advance(start + 5000, [&](TimerWheel::Entry *entry) {
+        EXPECT_LE(entry->expire_at, start + 5000);
+        fired.insert(entry);
+    });
+    wheel.Advance(start + 20000, [&](TimerWheel::Entry *entry) {
+        EXPECT_GT(entry->expire_at, start + 5000);
+        fired.insert(entry);
+    });
+    EXPECT_EQ(entries.size(), fired.size());
+    EXPECT_EQ(0, wheel.Size());
+}
@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+#include <ctime>
+#include <string>
+
+#include "storage/FrequencySketch.h"
+#include "storage/HashIndex.h"
+#include "storage/SimpleLRU.h"
+#include "storage/TinyLFU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+namespace {
+
+uint64_t Hash(const std::string &key) { return HashBytes(key.data(), key.size()); }
+
+} // namespace
+
+TEST(TinyLFUTest, FrequencySketch) {
+    FrequencySketch sketch(64);
+
+    for (int i = 0; i < 10; i++) {
+        sketch.Increment(Hash("hot"));
+    }
+    sketch.Increment(Hash("cold"));
+    EXPECT_EQ(10, sketch.Estimate(Hash("hot")));
+    EXPECT_LE(1, sketch.Estimate(Hash("cold")));
+    EXPECT_GT(10, sketch.Estimate(Hash("cold")));
+
+    // Counters saturate
+    for (int i = 0; i < 10; i++) {
+        sketch.Increment(Hash("hot"));
+    }
+    EXPECT_EQ(15, sketch.Estimate(Hash("hot")));
+
+    // Old popularity fades away
+    for (int i = 0; i < 1000; i++) {
+        sketch.Increment(Hash("Key " + std::to_string(i)));
+    }
+    EXPECT_GT(15, sketch.Estimate(Hash("hot")));
+}
+
+TEST(TinyLFUTest, PutGetDelete) {
+    TinyLFU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "val4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val4"));
+    EXPECT_FALSE(storage.Put("KEY3", std::string(1024, 'x')));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val4", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+
+    EXPECT_TRUE(storage.Put("KEY2", "new2", time(nullptr) - 1));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+
+    EXPECT_TRUE(storage.Put("KEY4", "val4"));
+    storage.FlushAll();
+    EXPECT_FALSE(storage.Get("KEY4", value));
+}
+
+TEST(TinyLFUTest, ValueBiggerThanWindow) {
+    TinyLFU storage(2000, 10);
+    std::string big(400, 'x');
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Set("KEY1", big));
+    EXPECT_TRUE(storage.Put("KEY2", big));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(big, value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Set("KEY1", "short"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("short", value);
+}
+
+TEST(TinyLFUTest, NewKeyInSmallCache) {
+    TinyLFU storage;
+    const std::string val(56, 'x');
+
+    // Window holds a few items even if the share is less than a single one
+    std::string value;
+    for (int i = 0; i < 100; i++) {
+        std::string key = "Key " + std::to_string(i);
+        EXPECT_TRUE(storage.Put(key, val));
+        EXPECT_TRUE(storage.Get(key, value));
+    }
+}
+
+TEST(TinyLFUTest, WindowValueGrows) {
+    TinyLFU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", std::string(100, 'x')));
+    EXPECT_TRUE(storage.Put("KEY2", std::string(100, 'y')));
+
+    // Window has no room for both anymore, the other item moves to the main LRU
+    EXPECT_TRUE(storage.Set("KEY1", std::string(200, 'z')));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(std::string(200, 'z'), value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ(std::string(100, 'y'), value);
+}
+
+TEST(TinyLFUTest, RejectedByAdmission) {
+    TinyLFU storage;
+    const std::string big(300, 'x');
+
+    // Items bigger than the window go to admission right away
+    EXPECT_TRUE(storage.Put("Hot1", big));
+    EXPECT_TRUE(storage.Put("Hot2", big));
+
+    std::string value;
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(storage.Get("Hot1", value));
+        EXPECT_TRUE(storage.Get("Hot2", value));
+    }
+
+    EXPECT_FALSE(storage.Put("Cold", big));
+    EXPECT_FALSE(storage.Get("Cold", value));
+    EXPECT_TRUE(storage.Get("Hot1", value));
+    EXPECT_TRUE(storage.Get("Hot2", value));
+}
+
+TEST(TinyLFUTest, ScanResistance) {
+    // Room for about 200 items
+    const size_t budget = 64 * 200;
+    const std::string val(56, 'x');
+    TinyLFU storage(budget);
+    SimpleLRU lru(budget);
+
+    // Frequently used keys
+    std::string value;
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < 50; i++) {
+            std::string key = "Hot " + std::to_string(i);
+            if (!storage.Get(key, value)) {
+                storage.Put(key, val);
+            }
+            if (!lru.Get(key, value)) {
+                lru.Put(key, val);
+            }
+        }
+    }
+
+    // One pass over cold keys, several times bigger than the cache
+    for (int i = 0; i < 1000; i++) {
+        std::string key = "Cold " + std::to_string(i);
+        storage.Put(key, val);
+        lru.Put(key, val);
+    }
+
+    size_t tinylfu_hits = 0, lru_hits = 0;
+    for (int i = 0; i < 50; i++) {
+        std::string key = "Hot " + std::to_string(i);
+        tinylfu_hits += storage.Get(key, value);
+        lru_hits += lru.Get(key, value);
+    }
+
+    // Sketch is approximate, so a few hot keys could lose to colliding cold ones
+    EXPECT_LE(45, tinylfu_hits);
+    EXPECT_EQ(0, lru_hits);
+}